@@ -0,0 +1,150 @@
+#include "attackheatmap.h"
+
+#include <QPainter>
+#include <algorithm>
+
+AttackHeatmap::AttackHeatmap(int boardSize, int squareSize, const BoardVariant &variant, QGraphicsItem *parent)
+    : QGraphicsItem(parent), boardSize(boardSize), squareSize(squareSize),
+      toroidal(variant.toroidal), superqueens(variant.superqueens),
+      regions(int(variant.regions.size()) == boardSize * boardSize ? variant.regions : std::vector<int>()),
+      image(boardSize, boardSize, QImage::Format_ARGB32_Premultiplied), imageDirty(true) {
+    setAcceptedMouseButtons(Qt::NoButton); // Clicks go through to the queens
+    clear();
+}
+
+QRectF AttackHeatmap::boundingRect() const {
+    return QRectF(0, 0, boardSize * squareSize, boardSize * squareSize);
+}
+
+void AttackHeatmap::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+
+    if (imageDirty) {
+        for (int row = 0; row < boardSize; ++row) {
+            QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(row));
+            for (int col = 0; col < boardSize; ++col) {
+                // More attackers, more opaque red
+                int alpha = std::min(attackersAt(row, col) * 45, 200);
+                line[col] = qPremultiply(qRgba(255, 0, 0, alpha));
+            }
+        }
+        imageDirty = false;
+    }
+
+    // Hard edges between squares, no blur from scaling
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, false);
+    painter->drawImage(boundingRect(), image);
+}
+
+void AttackHeatmap::clear() {
+    rowCount.assign(boardSize, 0);
+    colCount.assign(boardSize, 0);
+    diag1Count.assign(2 * boardSize - 1, 0);
+    diag2Count.assign(2 * boardSize - 1, 0);
+    regionCount.assign(boardSize, 0);
+    regionRowCount.assign(regions.empty() ? 0 : boardSize * boardSize, 0);
+    regionColCount.assign(regions.empty() ? 0 : boardSize * boardSize, 0);
+    nearCount.assign(boardSize * boardSize, 0);
+    queenCount.assign(boardSize * boardSize, 0);
+    imageDirty = true;
+    update();
+}
+
+void AttackHeatmap::addQueen(int row, int col) {
+    updateQueen(row, col, 1);
+}
+
+void AttackHeatmap::removeQueen(int row, int col) {
+    updateQueen(row, col, -1);
+}
+
+void AttackHeatmap::moveQueen(int fromRow, int fromCol, int toRow, int toCol) {
+    updateQueen(fromRow, fromCol, -1);
+    updateQueen(toRow, toCol, 1);
+}
+
+int AttackHeatmap::attackersAt(int row, int col) const {
+    if (row < 0 || row >= boardSize || col < 0 || col >= boardSize) {
+        return 0;
+    }
+
+    // Sum of the lines through the square, minus the queens that sit on two of them:
+    // a queen in the same row (or column) and region, or on a torus of even size the queen
+    // half a board away on both axes, whose two wrapped diagonals both pass through here.
+    // A queen on the square itself is on every line and isn't attacking it.
+    int square = row * boardSize + col;
+    if (!regions.empty()) {
+        const int region = regions[square];
+        return rowCount[row] + colCount[col] + regionCount[region] + nearCount[square]
+               - regionRowCount[region * boardSize + row] - regionColCount[region * boardSize + col]
+               - queenCount[square];
+    }
+    int attackers = rowCount[row] + colCount[col] + diag1Count[diag1Index(row, col)] +
+                    diag2Count[diag2Index(row, col)] + nearCount[square] - 4 * queenCount[square];
+    if (toroidal && boardSize % 2 == 0) {
+        const int half = boardSize / 2;
+        attackers -= queenCount[(row + half) % boardSize * boardSize + (col + half) % boardSize];
+    }
+    return attackers;
+}
+
+int AttackHeatmap::queensAt(int row, int col) const {
+    if (row < 0 || row >= boardSize || col < 0 || col >= boardSize) {
+        return 0;
+    }
+    return queenCount[row * boardSize + col];
+}
+
+void AttackHeatmap::updateQueen(int row, int col, int delta) {
+    if (row < 0 || row >= boardSize || col < 0 || col >= boardSize) {
+        return; // Queens dragged off the board don't attack anything
+    }
+
+    rowCount[row] += delta;
+    colCount[col] += delta;
+    diag1Count[diag1Index(row, col)] += delta;
+    diag2Count[diag2Index(row, col)] += delta;
+    queenCount[row * boardSize + col] += delta;
+
+    if (!regions.empty()) {
+        const int region = regions[row * boardSize + col];
+        regionCount[region] += delta;
+        regionRowCount[region * boardSize + row] += delta;
+        regionColCount[region * boardSize + col] += delta;
+
+        // Touching squares on the diagonals; the others share a row, column or region already
+        for (int rowStep : {-1, 1}) {
+            for (int colStep : {-1, 1}) {
+                int targetRow = row + rowStep;
+                int targetCol = col + colStep;
+                if (targetRow >= 0 && targetRow < boardSize && targetCol >= 0 && targetCol < boardSize &&
+                    regions[targetRow * boardSize + targetCol] != region) {
+                    nearCount[targetRow * boardSize + targetCol] += delta;
+                }
+            }
+        }
+    }
+
+    if (superqueens) {
+        static const int jumps[8][2] = {{1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2}};
+        for (const auto &jump : jumps) {
+            int targetRow = row + jump[0];
+            int targetCol = col + jump[1];
+            if (targetRow >= 0 && targetRow < boardSize && targetCol >= 0 && targetCol < boardSize) {
+                nearCount[targetRow * boardSize + targetCol] += delta;
+            }
+        }
+    }
+
+    imageDirty = true;
+    update(); // The scene coalesces these into at most one repaint per frame
+}
+
+int AttackHeatmap::diag1Index(int row, int col) const {
+    return toroidal ? (row + col) % boardSize : row + col;
+}
+
+int AttackHeatmap::diag2Index(int row, int col) const {
+    return toroidal ? (row - col + boardSize) % boardSize : row - col + boardSize - 1;
+}
@@ -0,0 +1,52 @@
+#ifndef ATTACKHEATMAP_H
+#define ATTACKHEATMAP_H
+
+#include <QGraphicsItem>
+#include <QImage>
+#include <vector>
+#include "boardvariant.h"
+
+// Overlay showing how many queens attack every square, each attacking queen counted once.
+// Kept up to date from row, column, diagonal (or region) and knight counters, so moving a
+// queen is O(1), and drawn as a single board-sized image instead of one item per square.
+class AttackHeatmap : public QGraphicsItem {
+
+public:
+    AttackHeatmap(int boardSize, int squareSize, const BoardVariant &variant, QGraphicsItem *parent = nullptr);
+
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+    void clear();
+    void addQueen(int row, int col);
+    void removeQueen(int row, int col);
+    void moveQueen(int fromRow, int fromCol, int toRow, int toCol);
+    int attackersAt(int row, int col) const;
+    int queensAt(int row, int col) const;
+
+private:
+    int boardSize;
+    int squareSize;
+    bool toroidal;
+    bool superqueens;
+    std::vector<int> regions; // Per square, colored-regions boards only
+
+    std::vector<int> rowCount;
+    std::vector<int> colCount;
+    std::vector<int> diag1Count;  // row + col (mod N on a torus)
+    std::vector<int> diag2Count;  // row - col + N - 1 (mod N on a torus)
+    std::vector<int> regionCount; // Per region, replaces the diagonals on colored-regions boards
+    std::vector<int> regionRowCount; // region * N + row, queens counted by both their row and their region
+    std::vector<int> regionColCount; // region * N + col, same for columns
+    std::vector<int> nearCount;   // Per square: knight jumps (superqueens) or touching squares (regions)
+    std::vector<int> queenCount;  // Per square, so a queen doesn't count itself
+
+    QImage image; // One pixel per square, scaled up when painted
+    bool imageDirty;
+
+    void updateQueen(int row, int col, int delta);
+    int diag1Index(int row, int col) const;
+    int diag2Index(int row, int col) const;
+};
+
+#endif // ATTACKHEATMAP_H
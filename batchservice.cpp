@@ -0,0 +1,295 @@
+#include "batchservice.h"
+#include "bitboard.h"
+#include "hintengine.h"
+#include "solutionsampler.h"
+#include "taskscheduler.h"
+
+#include <QCoreApplication>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QThread>
+#include <QFutureWatcher>
+#include <atomic>
+#include <deque>
+#include <iostream>
+#include <string>
+
+namespace {
+
+QJsonObject errorResponse(const QJsonObject &request, const QString &message) {
+    QJsonObject response;
+    if (request.contains("id")) {
+        response["id"] = request.value("id");
+    }
+    response["ok"] = false;
+    response["error"] = message;
+    return response;
+}
+
+QJsonArray toJson(const std::vector<int> &cols) {
+    QJsonArray array;
+    for (int col : cols) {
+        array.append(col);
+    }
+    return array;
+}
+
+QJsonArray toJson(int row, int col) {
+    return QJsonArray{row, col};
+}
+
+// [[row, col], ...] -> placement, false if a square is malformed or off the board
+bool parseSquares(const QJsonValue &value, int boardSize, HintEngine::Placement &squares) {
+    for (const QJsonValue &entry : value.toArray()) {
+        QJsonArray square = entry.toArray();
+        int row = square.at(0).toInt(-1);
+        int col = square.at(1).toInt(-1);
+        if (square.size() != 2 || row < 0 || row >= boardSize || col < 0 || col >= boardSize) {
+            return false;
+        }
+        squares.push_back({row, col});
+    }
+    return true;
+}
+
+} // namespace
+
+struct BatchService::ResponseStream {
+    std::deque<QFuture<QList<QByteArray>>> pending; // Oldest first
+    std::function<void(const QList<QByteArray> &)> write;
+
+    // Only from the head, so a finished batch waits for the ones sent before it
+    void flush() {
+        while (!pending.empty() && pending.front().isFinished()) {
+            const QList<QByteArray> responses = pending.front().result();
+            pending.pop_front();
+            write(responses);
+        }
+    }
+};
+
+BatchService::BatchService(QObject *parent)
+    : QObject(parent), server(nullptr), stdinReader(nullptr), stdinClosed(false) {
+}
+
+BatchService::~BatchService() {
+    if (stdinReader) {
+        stdinReader->wait();
+        delete stdinReader;
+    }
+}
+
+void BatchService::serveStdio() {
+    output.open(stdout, QIODevice::WriteOnly);
+    stdinStream = std::make_shared<ResponseStream>();
+    stdinStream->write = [this](const QList<QByteArray> &responses) {
+        for (const QByteArray &response : responses) {
+            output.write(response);
+            output.write("\n");
+        }
+        output.flush();
+        quitIfDone();
+    };
+
+    stdinReader = QThread::create([this]() {
+        std::string line;
+        while (std::getline(std::cin, line)) {
+            QMutexLocker locker(&stdinMutex);
+            bool wasIdle = stdinLines.isEmpty();
+            stdinLines.append(QByteArray::fromStdString(line));
+            locker.unlock();
+
+            // One wake-up per batch, lines arriving meanwhile join the pending one
+            if (wasIdle) {
+                QMetaObject::invokeMethod(this, "processStdin", Qt::QueuedConnection);
+            }
+        }
+
+        QMutexLocker locker(&stdinMutex);
+        stdinClosed = true;
+        locker.unlock();
+        QMetaObject::invokeMethod(this, "processStdin", Qt::QueuedConnection);
+    });
+    stdinReader->start();
+}
+
+void BatchService::processStdin() {
+    QMutexLocker locker(&stdinMutex);
+    QList<QByteArray> lines;
+    lines.swap(stdinLines);
+    locker.unlock();
+
+    if (!lines.isEmpty()) {
+        answerBatch(lines, this, stdinStream);
+    }
+    quitIfDone();
+}
+
+void BatchService::quitIfDone() {
+    QMutexLocker locker(&stdinMutex);
+    if (stdinClosed && stdinLines.isEmpty() && stdinStream->pending.empty()) {
+        QCoreApplication::quit();
+    }
+}
+
+bool BatchService::listen(const QString &name) {
+    server = new QLocalServer(this);
+    QLocalServer::removeServer(name); // Stale socket of a crashed run
+    if (!server->listen(name)) {
+        std::cerr << qPrintable(server->errorString()) << std::endl;
+        return false;
+    }
+    connect(server, &QLocalServer::newConnection, this, &BatchService::onNewConnection);
+    return true;
+}
+
+void BatchService::onNewConnection() {
+    while (QLocalSocket *socket = server->nextPendingConnection()) {
+        connect(socket, &QLocalSocket::disconnected, socket, &QLocalSocket::deleteLater);
+
+        auto stream = std::make_shared<ResponseStream>();
+        stream->write = [socket](const QList<QByteArray> &responses) {
+            for (const QByteArray &response : responses) {
+                socket->write(response);
+                socket->write("\n");
+            }
+        };
+        connect(socket, &QLocalSocket::readyRead, this, [socket, stream]() {
+            // Complete lines form the batch, a partial one waits in the socket buffer
+            QList<QByteArray> lines;
+            while (socket->canReadLine()) {
+                lines.append(socket->readLine().trimmed());
+            }
+            if (lines.isEmpty()) {
+                return;
+            }
+            answerBatch(lines, socket, stream);
+        });
+    }
+}
+
+QList<QByteArray> BatchService::handleBatch(const QList<QByteArray> &lines) {
+    if (lines.size() == 1) {
+        return {handleRequest(lines.first())}; // Not worth a trip to the pool
+    }
+    return TaskScheduler::instance().blockingMapped<QByteArray>(lines, TaskScheduler::Interactive,
+                                                                &BatchService::handleRequest);
+}
+
+void BatchService::answerBatch(const QList<QByteArray> &lines, QObject *context,
+                               const std::shared_ptr<ResponseStream> &stream) {
+    // Off the event loop, so a long count never holds up reading the next batch
+    QFuture<QList<QByteArray>> future = TaskScheduler::instance().run(TaskScheduler::Interactive, [lines]() {
+        return handleBatch(lines);
+    });
+    stream->pending.push_back(future);
+
+    auto *watcher = new QFutureWatcher<QList<QByteArray>>(context);
+    connect(watcher, &QFutureWatcherBase::finished, context, [watcher, stream]() {
+        watcher->deleteLater();
+        stream->flush();
+    });
+    watcher->setFuture(future);
+}
+
+QByteArray BatchService::handleRequest(const QByteArray &line) {
+    QJsonParseError parseError;
+    QJsonDocument document = QJsonDocument::fromJson(line, &parseError);
+    if (!document.isObject()) {
+        return QJsonDocument(errorResponse(QJsonObject(), "Invalid JSON: " + parseError.errorString()))
+            .toJson(QJsonDocument::Compact);
+    }
+
+    const QJsonObject request = document.object();
+    const QString op = request.value("op").toString();
+    const int boardSize = request.value("n").toInt();
+
+    auto reply = [](const QJsonObject &response) {
+        return QJsonDocument(response).toJson(QJsonDocument::Compact);
+    };
+
+    if (boardSize < 1 || boardSize > MAX_BITBOARD_SIZE) {
+        return reply(errorResponse(request, QString("n must be between 1 and %1").arg(MAX_BITBOARD_SIZE)));
+    }
+
+    BoardVariant variant;
+    variant.toroidal = request.value("toroidal").toBool();
+    variant.superqueens = request.value("superqueens").toBool();
+    HintEngine::Placement blocked;
+    if (!parseSquares(request.value("blocked"), boardSize, blocked)) {
+        return reply(errorResponse(request, "Malformed blocked squares"));
+    }
+    for (const auto &square : blocked) {
+        variant.setBlocked(boardSize, square.first, square.second, true);
+    }
+
+    QJsonObject response;
+    if (request.contains("id")) {
+        response["id"] = request.value("id");
+    }
+    response["ok"] = true;
+
+    if (op == "solve") {
+        // Random classic solution unless the first one is asked for
+        thread_local SolutionSampler sampler;
+        std::vector<int> cols;
+        if (variant.isClassic() && !request.value("first").toBool()) {
+            cols = sampler.sample(boardSize);
+        } else if (!variant.isUnsolvable(boardSize)) {
+            bool timedOut = false;
+            cols = findFirstSolution(boardSize, variant, QDeadlineTimer(SOLVE_BUDGET_MS), &timedOut);
+            if (timedOut) {
+                return reply(errorResponse(request, QString("solve gave up after %1 ms").arg(SOLVE_BUDGET_MS)));
+            }
+        }
+        response["solution"] = cols.empty() ? QJsonValue() : QJsonValue(toJson(cols));
+    } else if (op == "count") {
+        if (boardSize > MAX_COUNT_SIZE) {
+            return reply(errorResponse(request, QString("count is limited to n <= %1").arg(MAX_COUNT_SIZE)));
+        }
+
+        // Background units, so hints and solves of other requests get threads between them
+        const std::vector<Prefix> units = splitWorkUnits(boardSize, boardSize >= 14 ? 3 : 2, variant);
+        std::atomic<quint64> count{0};
+        TaskScheduler::instance().blockingFor(int(units.size()), TaskScheduler::Background, [&](int unit) {
+            count += searchFromPrefix(boardSize, units[unit], SolutionVisitor(), variant);
+        });
+        response["count"] = qint64(count.load());
+    } else if (op == "hint" || op == "validate") {
+        HintEngine::Placement queens;
+        if (!parseSquares(request.value("queens"), boardSize, queens)) {
+            return reply(errorResponse(request, "Malformed queens"));
+        }
+
+        HintEngine engine(boardSize, variant, queens,
+                          request.contains("seed") ? unsigned(request.value("seed").toInt()) : std::random_device()());
+        const int conflicts = engine.calculateConflicts();
+        const bool solved = conflicts == 0 && int(queens.size()) == boardSize;
+
+        if (op == "validate") {
+            response["valid"] = solved;
+            response["conflicts"] = conflicts;
+        } else {
+            QList<Hint> hints;
+            response["solved"] = solved;
+            if (!solved && engine.suggestHint(hints)) {
+                const Hint &hint = hints.first();
+                QJsonObject hintObject;
+                hintObject["from"] = toJson(hint.fromRow, hint.fromCol);
+                hintObject["to"] = toJson(hint.toRow, hint.toCol);
+                hintObject["strategy"] = hint.strategy;
+                hintObject["description"] = hint.description;
+                response["hint"] = hintObject;
+            } else {
+                response["hint"] = QJsonValue();
+            }
+        }
+    } else {
+        return reply(errorResponse(request, QString("Unknown op '%1'").arg(op)));
+    }
+
+    return reply(response);
+}
@@ -0,0 +1,61 @@
+#ifndef BATCHSERVICE_H
+#define BATCHSERVICE_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QList>
+#include <QMutex>
+#include <QFile>
+#include <functional>
+#include <memory>
+
+class QLocalServer;
+class QThread;
+
+// Headless solver and hint service speaking JSON lines, one request per line:
+//   {"id": 1, "op": "solve",    "n": 8}                      -> {"id": 1, "ok": true, "solution": [0, 4, ...]}
+//   {"id": 2, "op": "count",    "n": 10}                     -> {"id": 2, "ok": true, "count": 724}
+//   {"id": 3, "op": "hint",     "n": 4, "queens": [[0,0], ...]} -> {"id": 3, "ok": true, "hint": {...}}
+//   {"id": 4, "op": "validate", "n": 4, "queens": [[0,1], ...]} -> {"id": 4, "ok": true, "valid": true}
+// Optional "toroidal", "superqueens" and "blocked": [[row, col], ...] select a variant.
+// "count" is limited to MAX_COUNT_SIZE, larger boards would hold the workers for hours; a "solve" that
+// has to search gives up after SOLVE_BUDGET_MS with an error response.
+// Whatever has arrived is answered as one batch on the shared pool. Batches run concurrently, but every
+// stream (stdin or a socket) gets its responses in request order: a quick batch waits for an earlier count.
+class BatchService : public QObject {
+    Q_OBJECT
+
+public:
+    explicit BatchService(QObject *parent = nullptr);
+    ~BatchService();
+
+    void serveStdio();                  // Answer stdin on stdout, quit the app at end of input
+    bool listen(const QString &name);   // Answer clients of a QLocalServer
+
+    static constexpr int MAX_COUNT_SIZE = 17; // 95,815,104 classic solutions, seconds on a few cores
+    static constexpr int SOLVE_BUDGET_MS = 2000;
+
+    static QByteArray handleRequest(const QByteArray &line);
+    static QList<QByteArray> handleBatch(const QList<QByteArray> &lines);
+
+private slots:
+    void processStdin();
+    void onNewConnection();
+
+private:
+    struct ResponseStream; // Batches of one client, written out in the order they arrived
+    static void answerBatch(const QList<QByteArray> &lines, QObject *context,
+                            const std::shared_ptr<ResponseStream> &stream);
+    void quitIfDone(); // At end of input, once every batch was answered
+
+    QLocalServer *server;
+
+    QThread *stdinReader;          // Blocking reads happen off the event loop
+    QMutex stdinMutex;
+    QList<QByteArray> stdinLines;  // Read but not answered yet
+    bool stdinClosed;
+    std::shared_ptr<ResponseStream> stdinStream;
+    QFile output;
+};
+
+#endif // BATCHSERVICE_H
@@ -0,0 +1,111 @@
+// Attack heatmap cross-check: the counters of AttackHeatmap against a plain pairwise
+// count with BoardVariant::attacks, on random boards of every variant.
+//
+//   cmake -DQTQUEENS_BUILD_BENCHMARKS=ON .. && make heatmapcheck
+//   ./heatmapcheck [boards] [seed]
+//
+// Every board gets queens added, moved and removed (several may share a square), then
+// each square is compared. Exits with 1 on the first few mismatches, 0 if all agree.
+
+#include <QCoreApplication>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "attackheatmap.h"
+#include "boardvariant.h"
+
+namespace {
+
+struct Square {
+    int row;
+    int col;
+};
+
+const char *const variantNames[] = {"classic", "toroidal", "superqueens", "toroidal superqueens", "regions"};
+
+BoardVariant randomVariant(int kind, int boardSize, std::mt19937 &rng) {
+    BoardVariant variant;
+    variant.toroidal = kind == 1 || kind == 3;
+    variant.superqueens = kind == 2 || kind == 3;
+    if (kind == 4) {
+        // Any assignment will do: the counts don't rely on regions being connected
+        std::uniform_int_distribution<int> region(0, boardSize - 1);
+        variant.regions.resize(boardSize * boardSize);
+        for (int &squareRegion : variant.regions) {
+            squareRegion = region(rng);
+        }
+    }
+    return variant;
+}
+
+// Distinct queens attacking the square, a queen on the square itself doesn't count
+int pairwiseAttackers(int boardSize, const BoardVariant &variant, const std::vector<Square> &queens, int row, int col) {
+    int attackers = 0;
+    for (const Square &queen : queens) {
+        if ((queen.row != row || queen.col != col) && variant.attacks(boardSize, queen.row, queen.col, row, col)) {
+            ++attackers;
+        }
+    }
+    return attackers;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+
+    const int boards = argc > 1 ? std::max(1, std::atoi(argv[1])) : 5000;
+    std::mt19937 rng(argc > 2 ? unsigned(std::atoi(argv[2])) : 1u);
+    const int variantCount = int(sizeof(variantNames) / sizeof(variantNames[0]));
+
+    int mismatches = 0;
+    int board = 0;
+    quint64 squaresChecked = 0;
+    for (; board < boards && mismatches < 10; ++board) {
+        // Knight jumps and wrapped diagonals only coincide below 4x4; odd and even sizes both matter on a torus
+        const int boardSize = std::uniform_int_distribution<int>(4, 16)(rng);
+        const int kind = board % variantCount;
+        const BoardVariant variant = randomVariant(kind, boardSize, rng);
+        std::uniform_int_distribution<int> coordinate(0, boardSize - 1);
+
+        AttackHeatmap heatmap(boardSize, 10, variant);
+        std::vector<Square> queens;
+        const int queenCount = std::uniform_int_distribution<int>(1, 2 * boardSize)(rng);
+        for (int i = 0; i < queenCount; ++i) {
+            Square queen{coordinate(rng), coordinate(rng)};
+            queens.push_back(queen);
+            heatmap.addQueen(queen.row, queen.col);
+        }
+
+        // The incremental paths the board uses while playing
+        for (int i = 0; i < boardSize; ++i) {
+            Square &queen = queens[std::uniform_int_distribution<int>(0, int(queens.size()) - 1)(rng)];
+            Square to{coordinate(rng), coordinate(rng)};
+            heatmap.moveQueen(queen.row, queen.col, to.row, to.col);
+            queen = to;
+        }
+        if (queens.size() > 1) {
+            const Square removed = queens.back();
+            queens.pop_back();
+            heatmap.removeQueen(removed.row, removed.col);
+        }
+
+        for (int row = 0; row < boardSize; ++row) {
+            for (int col = 0; col < boardSize; ++col) {
+                ++squaresChecked;
+                const int expected = pairwiseAttackers(boardSize, variant, queens, row, col);
+                const int counted = heatmap.attackersAt(row, col);
+                if (expected != counted && ++mismatches <= 10) {
+                    std::printf("%s %dx%d, %zu queens: square (%d, %d) has %d attackers, heatmap says %d\n",
+                                variantNames[kind], boardSize, boardSize, queens.size(), row, col, expected, counted);
+                }
+            }
+        }
+    }
+
+    std::printf("%llu squares on %d boards checked, %d mismatches\n",
+                static_cast<unsigned long long>(squaresChecked), board, mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
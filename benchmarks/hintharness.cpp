@@ -0,0 +1,159 @@
+// Hint quality harness: plays many random starting boards to the end with each
+// hint strategy and reports how often, how fast and how cheaply it solves them.
+//
+//   cmake -DQTQUEENS_BUILD_BENCHMARKS=ON .. && make hintharness
+//   ./hintharness [trials] [moveCap] [sizes...]
+//
+// Games run in parallel on the app's shared pool (QTQUEENS_THREADS sets its size);
+// every game has its own seed, so a run is reproducible for a given set of arguments.
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "hintengine.h"
+#include "taskscheduler.h"
+
+namespace {
+
+using Strategy = bool (HintEngine::*)(QList<Hint> &);
+
+struct StrategyInfo {
+    const char *name;
+    Strategy suggest;
+};
+
+const StrategyInfo strategies[] = {
+    {"cascade", &HintEngine::suggestHint},
+    {"safe", &HintEngine::suggestSafeMove},
+    {"least-conflict", &HintEngine::suggestLeastConflictMove},
+    {"conflict-breaker", &HintEngine::suggestConflictBreaker},
+    {"future-safe", &HintEngine::suggestFutureSafeMove},
+    {"random", &HintEngine::suggestRandomMove},
+};
+
+struct Game {
+    int boardSize;
+    int strategy;
+    int moveCap;
+    unsigned int seed;
+};
+
+struct GameResult {
+    bool solved = false;
+    int moves = 0;
+    int calls = 0;              // Suggest calls, including the last one if it found nothing
+    qint64 hintNanoseconds = 0; // Calls that gave the hint played next
+    qint64 callNanoseconds = 0; // Every call: strategies that search and then give up pay here
+};
+
+HintEngine::Placement randomPlacement(int boardSize, std::mt19937 &rng) {
+    // boardSize queens on distinct random squares
+    std::vector<int> squares(boardSize * boardSize);
+    for (int i = 0; i < int(squares.size()); ++i) {
+        squares[i] = i;
+    }
+    std::shuffle(squares.begin(), squares.end(), rng);
+
+    HintEngine::Placement placement;
+    for (int i = 0; i < boardSize; ++i) {
+        placement.push_back({squares[i] / boardSize, squares[i] % boardSize});
+    }
+    return placement;
+}
+
+GameResult play(const Game &game) {
+    std::mt19937 rng(game.seed);
+    HintEngine engine(game.boardSize, BoardVariant(), randomPlacement(game.boardSize, rng), game.seed);
+    const Strategy suggest = strategies[game.strategy].suggest;
+
+    GameResult result;
+    QElapsedTimer timer;
+    while (result.moves < game.moveCap) {
+        if (engine.calculateConflicts() == 0) {
+            result.solved = true;
+            break;
+        }
+
+        QList<Hint> hints;
+        timer.start();
+        bool found = (engine.*suggest)(hints);
+        const qint64 elapsed = timer.nsecsElapsed();
+        ++result.calls;
+        result.callNanoseconds += elapsed;
+        if (!found) {
+            break; // Strategy is stuck
+        }
+        result.hintNanoseconds += elapsed;
+
+        const Hint &hint = hints.first();
+        engine.moveQueen(hint.fromRow, hint.fromCol, hint.toRow, hint.toCol);
+        ++result.moves;
+    }
+    if (!result.solved) {
+        result.solved = engine.calculateConflicts() == 0;
+    }
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+
+    int trials = argc > 1 ? std::max(1, std::atoi(argv[1])) : 200;
+    int moveCap = argc > 2 ? std::max(1, std::atoi(argv[2])) : 200;
+    std::vector<int> sizes;
+    for (int i = 3; i < argc; ++i) {
+        sizes.push_back(std::atoi(argv[i]));
+    }
+    if (sizes.empty()) {
+        sizes = {6, 8, 10, 12};
+    }
+
+    const int strategyCount = int(sizeof(strategies) / sizeof(strategies[0]));
+
+    std::printf("   N  strategy           solved  mean moves   hints  us/hint   calls  us/call\n");
+    for (int boardSize : sizes) {
+        if (boardSize < 1) {
+            continue;
+        }
+
+        for (int strategy = 0; strategy < strategyCount; ++strategy) {
+            // Same seeds for every strategy, so they face the same boards
+            QList<Game> games;
+            for (int trial = 0; trial < trials; ++trial) {
+                games.append({boardSize, strategy, moveCap, unsigned(boardSize * 1000003 + trial)});
+            }
+
+            QList<GameResult> results = TaskScheduler::instance().blockingMapped<GameResult>(games, TaskScheduler::Background, play);
+
+            int solved = 0;
+            qint64 solvedMoves = 0;
+            qint64 hints = 0;
+            qint64 nanoseconds = 0;
+            qint64 calls = 0;
+            qint64 callNanoseconds = 0;
+            for (const GameResult &result : results) {
+                if (result.solved) {
+                    ++solved;
+                    solvedMoves += result.moves;
+                }
+                hints += result.moves;
+                nanoseconds += result.hintNanoseconds;
+                calls += result.calls;
+                callNanoseconds += result.callNanoseconds;
+            }
+
+            std::printf("%4d  %-16s %7.1f%% %11.2f %7lld %8.2f %7lld %8.2f\n", boardSize, strategies[strategy].name,
+                        100.0 * solved / trials, solved ? double(solvedMoves) / solved : 0.0,
+                        static_cast<long long>(hints), hints ? nanoseconds / 1000.0 / hints : 0.0,
+                        static_cast<long long>(calls), calls ? callNanoseconds / 1000.0 / calls : 0.0);
+        }
+    }
+
+    return 0;
+}
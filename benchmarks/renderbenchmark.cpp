@@ -0,0 +1,160 @@
+// Offscreen rendering benchmark: times the ChessBoard drawing paths without a display.
+//
+//   cmake -DQTQUEENS_BUILD_BENCHMARKS=ON .. && make renderbenchmark
+//   ./renderbenchmark [repetitions] [sizes...]
+//
+// Every operation is repeated and reported as frame-time percentiles plus the
+// number of heap allocations it made (counted by the operator new below).
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QPainter>
+#include <QGraphicsScene>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <vector>
+#include "chessboard.h"
+
+static std::atomic<quint64> allocationCount{0};
+
+void *operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void *memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+namespace {
+
+struct Measurement {
+    std::vector<double> milliseconds;
+    quint64 allocations = 0;
+};
+
+Measurement measure(int repetitions, const std::function<void()> &setup, const std::function<void()> &operation) {
+    Measurement result;
+    for (int i = 0; i < repetitions; ++i) {
+        if (setup) {
+            setup();
+        }
+        quint64 allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+        QElapsedTimer timer;
+        timer.start();
+        operation();
+        result.milliseconds.push_back(timer.nsecsElapsed() / 1e6);
+        result.allocations += allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+    }
+    return result;
+}
+
+double percentile(std::vector<double> values, double fraction) {
+    std::sort(values.begin(), values.end());
+    size_t index = std::min(values.size() - 1, size_t(fraction * (values.size() - 1) + 0.5));
+    return values[index];
+}
+
+void report(int boardSize, const char *name, const Measurement &result) {
+    std::printf("%4d  %-16s %10.3f %10.3f %10.3f %10.3f %12.1f\n", boardSize, name,
+                percentile(result.milliseconds, 0.5), percentile(result.milliseconds, 0.9),
+                percentile(result.milliseconds, 0.99), percentile(result.milliseconds, 1.0),
+                double(result.allocations) / result.milliseconds.size());
+}
+
+void placeDiagonal(ChessBoard &board, int boardSize) {
+    // Diagonal queens always conflict, so checkConflicts never pops the success dialog
+    board.clearQueens();
+    for (int i = 0; i < boardSize; ++i) {
+        board.addQueen(i, i);
+    }
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    int repetitions = argc > 1 ? std::max(1, std::atoi(argv[1])) : 50;
+    std::vector<int> sizes;
+    for (int i = 2; i < argc; ++i) {
+        sizes.push_back(std::atoi(argv[i]));
+    }
+    if (sizes.empty()) {
+        for (int boardSize = 4; boardSize <= 25; ++boardSize) {
+            sizes.push_back(boardSize);
+        }
+        sizes.insert(sizes.end(), {32, 50, 64, 100});
+    }
+
+    ChessBoard board;
+    QImage frame(580, 580, QImage::Format_ARGB32_Premultiplied);
+
+    std::printf("   N  operation           p50 ms     p90 ms     p99 ms     max ms  allocs/op\n");
+    for (int boardSize : sizes) {
+        if (boardSize < 1 || boardSize > 580) {
+            continue; // drawBoard needs at least one pixel per square
+        }
+
+        report(boardSize, "setBoardSize", measure(repetitions, nullptr, [&]() {
+            board.setBoardSize(boardSize);
+        }));
+        placeDiagonal(board, boardSize);
+
+        // Nothing changed: only the highlights are cleared
+        report(boardSize, "drawBoard", measure(repetitions, nullptr, [&]() {
+            board.drawBoard();
+        }));
+
+        // Every square, the heatmap and the queens rebuilt
+        report(boardSize, "drawBoard full", measure(repetitions, [&]() {
+            board.invalidateBoard();
+        }, [&]() {
+            board.drawBoard();
+        }));
+
+        report(boardSize, "checkConflicts", measure(repetitions, nullptr, [&]() {
+            board.checkConflicts();
+        }));
+
+        // Cleared first, so every call really highlights a square
+        report(boardSize, "highlightSquare", measure(repetitions, [&]() {
+            board.drawBoard();
+        }, [&]() {
+            for (int i = 0; i < boardSize; ++i) {
+                board.highlightSquare(i, (i + 1) % boardSize, Qt::green);
+            }
+        }));
+
+        report(boardSize, "clearHighlights", measure(repetitions, [&]() {
+            for (int i = 0; i < boardSize; ++i) {
+                board.highlightSquare(i, (i + 1) % boardSize, Qt::green);
+            }
+        }, [&]() {
+            board.drawBoard();
+        }));
+
+        report(boardSize, "scenePaint", measure(repetitions, nullptr, [&]() {
+            frame.fill(Qt::white);
+            QPainter painter(&frame);
+            board.scene()->render(&painter);
+        }));
+    }
+
+    return 0;
+}
@@ -0,0 +1,261 @@
+#include "bitboard.h"
+
+#include <QtAlgorithms>
+
+namespace {
+
+// Masks of the squares attacked on the current row.
+// diag1 shifts left and diag2 shifts right as we go down one row (rotating on a torus),
+// lastQueen and queenBefore hold the queens of the two rows above for knight attacks.
+// With colored regions the diagonals only cover the squares touching the last queen,
+// and regionsUsed has one bit per region that already has its queen.
+struct SearchState {
+    int row;
+    quint64 cols;
+    quint64 diag1;
+    quint64 diag2;
+    quint64 lastQueen;
+    quint64 queenBefore;
+    quint64 regionsUsed;
+};
+
+struct Searcher {
+    int boardSize;
+    quint64 full;
+    const BoardVariant &variant;
+    std::vector<quint64> allowed; // Per row, squares not blocked and matching any fixed queen
+    std::vector<quint64> regionRows; // region * N + row: squares of the region on that row (regions only)
+    bool stopped;
+    const QDeadlineTimer *deadline; // Checked every few thousand nodes (none: run to the end)
+    quint64 nodes;
+    bool timedOut;
+
+    Searcher(int boardSize, const BoardVariant &variant)
+        : boardSize(boardSize), full(boardSize >= 64 ? ~quint64(0) : (quint64(1) << boardSize) - 1),
+          variant(variant), allowed(boardSize), stopped(false), deadline(nullptr), nodes(0), timedOut(false) {
+        for (int row = 0; row < boardSize; ++row) {
+            allowed[row] = variant.allowedInRow(row, full);
+        }
+        if (int(variant.regions.size()) == boardSize * boardSize) {
+            regionRows.assign(boardSize * boardSize, 0);
+            for (int row = 0; row < boardSize; ++row) {
+                for (int col = 0; col < boardSize; ++col) {
+                    int region = variant.regionAt(boardSize, row, col);
+                    if (region >= 0 && region < boardSize) {
+                        regionRows[region * boardSize + row] |= quint64(1) << col;
+                    } else {
+                        allowed[row] &= ~(quint64(1) << col); // Not part of any region
+                    }
+                }
+            }
+        }
+    }
+
+    quint64 available(const SearchState &state) const {
+        quint64 taken = state.cols | state.diag1 | state.diag2;
+        if (variant.superqueens) {
+            taken |= (state.lastQueen << 2) | (state.lastQueen >> 2) |
+                     (state.queenBefore << 1) | (state.queenBefore >> 1);
+        }
+        for (quint64 used = state.regionsUsed; used; used &= used - 1) {
+            taken |= regionRows[qCountTrailingZeroBits(used) * boardSize + state.row];
+        }
+        return allowed[state.row] & ~taken;
+    }
+
+    SearchState place(const SearchState &state, quint64 bit) const {
+        if (!regionRows.empty()) {
+            // Only the squares touching this queen are taken on the next row
+            int region = variant.regionAt(boardSize, state.row, qCountTrailingZeroBits(bit));
+            return { state.row + 1, state.cols | bit, (bit << 1) & full, bit >> 1, bit, state.lastQueen,
+                     state.regionsUsed | (quint64(1) << region) };
+        }
+
+        quint64 diag1 = state.diag1 | bit;
+        quint64 diag2 = state.diag2 | bit;
+        if (variant.toroidal) {
+            diag1 = ((diag1 << 1) | (diag1 >> (boardSize - 1))) & full;
+            diag2 = ((diag2 >> 1) | (diag2 << (boardSize - 1))) & full;
+        } else {
+            diag1 = (diag1 << 1) & full;
+            diag2 = diag2 >> 1;
+        }
+        return { state.row + 1, state.cols | bit, diag1, diag2, bit, state.lastQueen, 0 };
+    }
+
+    quint64 searchRows(const SearchState &state, std::vector<int> &placement, const SolutionVisitor &visitor) {
+        if (deadline && (++nodes & 0xfff) == 0 && deadline->hasExpired()) {
+            stopped = timedOut = true;
+            return 0;
+        }
+        if (state.row == boardSize) {
+            if (visitor && !visitor(placement)) {
+                stopped = true;
+            }
+            return 1;
+        }
+
+        quint64 count = 0;
+        quint64 candidates = available(state);
+        while (candidates && !stopped) {
+            quint64 bit = candidates & (~candidates + 1); // Lowest free square
+            candidates ^= bit;
+            placement[state.row] = qCountTrailingZeroBits(bit);
+            count += searchRows(place(state, bit), placement, visitor);
+        }
+        return count;
+    }
+
+    void collectPrefixes(int depth, const SearchState &state, Prefix &prefix, std::vector<Prefix> &units) const {
+        if (state.row == depth) {
+            units.push_back(prefix);
+            return;
+        }
+
+        quint64 candidates = available(state);
+        while (candidates) {
+            quint64 bit = candidates & (~candidates + 1);
+            candidates ^= bit;
+            prefix.push_back(qCountTrailingZeroBits(bit));
+            collectPrefixes(depth, place(state, bit), prefix, units);
+            prefix.pop_back();
+        }
+    }
+};
+
+} // namespace
+
+std::vector<Prefix> splitWorkUnits(int boardSize, int depth, const BoardVariant &variant) {
+    std::vector<Prefix> units;
+    if (boardSize < 1 || boardSize > MAX_BITBOARD_SIZE) {
+        return units;
+    }
+
+    Searcher searcher(boardSize, variant);
+    Prefix prefix;
+    searcher.collectPrefixes(qBound(0, depth, boardSize), {0, 0, 0, 0, 0, 0, 0}, prefix, units);
+    return units;
+}
+
+quint64 searchFromPrefix(int boardSize, const Prefix &prefix, const SolutionVisitor &visitor,
+                         const BoardVariant &variant) {
+    if (boardSize < 1 || boardSize > MAX_BITBOARD_SIZE || int(prefix.size()) > boardSize) {
+        return 0;
+    }
+
+    Searcher searcher(boardSize, variant);
+    SearchState state = {0, 0, 0, 0, 0, 0, 0};
+    std::vector<int> placement(boardSize, -1);
+
+    // Replay the prefix, rejecting it if it is not a valid partial placement
+    for (int col : prefix) {
+        if (col < 0 || col >= boardSize) {
+            return 0;
+        }
+        quint64 bit = quint64(1) << col;
+        if (!(searcher.available(state) & bit)) {
+            return 0;
+        }
+        placement[state.row] = col;
+        state = searcher.place(state, bit);
+    }
+
+    return searcher.searchRows(state, placement, visitor);
+}
+
+std::vector<int> findFirstSolution(int boardSize, const BoardVariant &variant) {
+    std::vector<int> solution;
+    searchFromPrefix(boardSize, Prefix(), [&solution](const std::vector<int> &cols) {
+        solution = cols;
+        return false; // One is enough
+    }, variant);
+    return solution;
+}
+
+std::vector<int> findFirstSolution(int boardSize, const BoardVariant &variant, const QDeadlineTimer &deadline,
+                                   bool *timedOut) {
+    std::vector<int> solution;
+    if (timedOut) {
+        *timedOut = false;
+    }
+    if (boardSize < 1 || boardSize > MAX_BITBOARD_SIZE) {
+        return solution;
+    }
+
+    Searcher searcher(boardSize, variant);
+    searcher.deadline = &deadline;
+    std::vector<int> placement(boardSize, -1);
+    searcher.searchRows({0, 0, 0, 0, 0, 0, 0}, placement, [&solution](const std::vector<int> &cols) {
+        solution = cols;
+        return false;
+    });
+    if (timedOut) {
+        *timedOut = searcher.timedOut;
+    }
+    return solution;
+}
+
+// Frame `row` holds the masks on that row and the squares there that were not tried yet
+struct SolutionIterator::Search {
+    Searcher searcher;
+    std::vector<SearchState> states;
+    std::vector<quint64> untried;
+    std::vector<int> placement;
+    int row;
+
+    Search(int boardSize, const BoardVariant &variant)
+        : searcher(boardSize, variant), states(boardSize + 1), untried(boardSize), placement(boardSize, -1), row(0) {
+        states[0] = {0, 0, 0, 0, 0, 0, 0};
+        untried[0] = searcher.available(states[0]);
+    }
+};
+
+SolutionIterator::SolutionIterator(int boardSize, const BoardVariant &variant)
+    : boardSize(boardSize), variant(variant), count(0) {
+    reset();
+}
+
+SolutionIterator::~SolutionIterator() = default;
+
+void SolutionIterator::reset() {
+    count = 0;
+    search.reset();
+    if (boardSize >= 1 && boardSize <= MAX_BITBOARD_SIZE) {
+        search.reset(new Search(boardSize, variant)); // Refers to our copy of the variant
+    }
+}
+
+bool SolutionIterator::next(std::vector<int> &cols) {
+    if (!search) {
+        return false;
+    }
+
+    Search &s = *search;
+    while (s.row >= 0) {
+        if (!s.untried[s.row]) {
+            --s.row; // Row exhausted, back to the one above
+            continue;
+        }
+
+        quint64 bit = s.untried[s.row] & (~s.untried[s.row] + 1);
+        s.untried[s.row] ^= bit;
+        s.placement[s.row] = qCountTrailingZeroBits(bit);
+
+        if (s.row + 1 == boardSize) {
+            cols = s.placement; // Suspend here, the next pull tries the rest of this row
+            ++count;
+            return true;
+        }
+
+        s.states[s.row + 1] = s.searcher.place(s.states[s.row], bit);
+        ++s.row;
+        s.untried[s.row] = s.searcher.available(s.states[s.row]);
+    }
+
+    search.reset(); // Exhausted
+    return false;
+}
+
+quint64 SolutionIterator::yielded() const {
+    return count;
+}
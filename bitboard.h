@@ -0,0 +1,57 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <QtGlobal>
+#include <QDeadlineTimer>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "boardvariant.h"
+
+// Largest board the 64-bit masks can represent
+constexpr int MAX_BITBOARD_SIZE = 64;
+
+// A partial placement: the column of the queen on each of the first rows
+using Prefix = std::vector<int>;
+
+// Called with the full column list (one entry per row) of every solution found.
+// Return false to stop the search.
+using SolutionVisitor = std::function<bool(const std::vector<int> &)>;
+
+// Split the search tree into independent work units by expanding the first `depth` rows
+std::vector<Prefix> splitWorkUnits(int boardSize, int depth, const BoardVariant &variant = BoardVariant());
+
+// Visit every solution extending the given prefix and return how many were visited.
+// Pass an empty visitor to only count.
+quint64 searchFromPrefix(int boardSize, const Prefix &prefix, const SolutionVisitor &visitor = SolutionVisitor(),
+                         const BoardVariant &variant = BoardVariant());
+
+// First solution of the variant in column order, or empty if there is none
+std::vector<int> findFirstSolution(int boardSize, const BoardVariant &variant = BoardVariant());
+
+// Same, but gives up once the deadline passes: then it returns empty and sets *timedOut
+std::vector<int> findFirstSolution(int boardSize, const BoardVariant &variant, const QDeadlineTimer &deadline,
+                                   bool *timedOut);
+
+// Pull-based search: yields the solutions one at a time, in the same order as searchFromPrefix.
+// Between pulls the search is suspended on an explicit stack of one frame per row, so each
+// next() resumes where the previous one stopped instead of restarting from the root.
+class SolutionIterator {
+
+public:
+    SolutionIterator(int boardSize, const BoardVariant &variant = BoardVariant());
+    ~SolutionIterator();
+
+    bool next(std::vector<int> &cols); // False once every solution has been yielded
+    quint64 yielded() const;           // Solutions returned by next() so far
+    void reset();                      // Start over from the first solution
+
+private:
+    struct Search;
+    std::unique_ptr<Search> search;
+    int boardSize;
+    BoardVariant variant;
+    quint64 count;
+};
+
+#endif // BITBOARD_H
@@ -0,0 +1,136 @@
+#include "boardvariant.h"
+
+#include <cstdlib>
+#include <numeric>
+
+bool BoardVariant::isClassic() const {
+    if (toroidal || superqueens || hasRegions()) {
+        return false;
+    }
+    for (quint64 blocked : blockedRows) {
+        if (blocked) {
+            return false;
+        }
+    }
+    for (int col : fixedCols) {
+        if (col >= 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BoardVariant::attacks(int boardSize, int row1, int col1, int row2, int col2) const {
+    if (row1 == row2 || col1 == col2) {
+        return true;
+    }
+
+    int rowDistance = std::abs(row1 - row2);
+    int colDistance = std::abs(col1 - col2);
+
+    if (hasRegions()) {
+        int region = regionAt(boardSize, row1, col1);
+        return (rowDistance <= 1 && colDistance <= 1) ||
+               (region >= 0 && region == regionAt(boardSize, row2, col2));
+    }
+
+    if (rowDistance == colDistance) {
+        return true;
+    }
+    if (toroidal && boardSize > 0 &&
+        ((((row1 - col1) - (row2 - col2)) % boardSize == 0) || (((row1 + col1) - (row2 + col2)) % boardSize == 0))) {
+        return true;
+    }
+    if (superqueens && ((rowDistance == 1 && colDistance == 2) || (rowDistance == 2 && colDistance == 1))) {
+        return true;
+    }
+    return false;
+}
+
+bool BoardVariant::isBlocked(int row, int col) const {
+    return row >= 0 && row < int(blockedRows.size()) && col >= 0 && col < 64 &&
+           (blockedRows[row] >> col) & 1;
+}
+
+int BoardVariant::fixedCol(int row) const {
+    return row >= 0 && row < int(fixedCols.size()) ? fixedCols[row] : -1;
+}
+
+bool BoardVariant::hasRegions() const {
+    return !regions.empty();
+}
+
+bool BoardVariant::isUnsolvable(int boardSize) const {
+    return toroidal && !hasRegions() && std::gcd(boardSize, 6) != 1;
+}
+
+int BoardVariant::regionAt(int boardSize, int row, int col) const {
+    if (int(regions.size()) != boardSize * boardSize || row < 0 || row >= boardSize || col < 0 || col >= boardSize) {
+        return -1;
+    }
+    return regions[row * boardSize + col];
+}
+
+void BoardVariant::setBlocked(int boardSize, int row, int col, bool blocked) {
+    if (row < 0 || row >= boardSize || col < 0 || col >= 64) {
+        return;
+    }
+    blockedRows.resize(boardSize, 0);
+    if (blocked) {
+        blockedRows[row] |= quint64(1) << col;
+    } else {
+        blockedRows[row] &= ~(quint64(1) << col);
+    }
+}
+
+void BoardVariant::setFixedQueen(int boardSize, int row, int col) {
+    if (row < 0 || row >= boardSize) {
+        return;
+    }
+    fixedCols.resize(boardSize, -1);
+    fixedCols[row] = col;
+}
+
+quint64 BoardVariant::allowedInRow(int row, quint64 full) const {
+    quint64 allowed = full;
+    if (row < int(blockedRows.size())) {
+        allowed &= ~blockedRows[row];
+    }
+    int col = fixedCol(row);
+    if (col >= 0) {
+        allowed &= col < 64 ? quint64(1) << col : 0;
+    }
+    return allowed;
+}
+
+QString BoardVariant::describe() const {
+    if (isClassic()) {
+        return "classic";
+    }
+
+    QString text;
+    if (toroidal) {
+        text += "torus;";
+    }
+    if (superqueens) {
+        text += "superqueens;";
+    }
+    if (hasRegions()) {
+        text += "regions:";
+        for (int region : regions) {
+            text += QString::number(region) + ",";
+        }
+        text += ";";
+    }
+    for (int row = 0; row < int(blockedRows.size()); ++row) {
+        if (blockedRows[row]) {
+            text += QString("b%1:%2;").arg(row).arg(blockedRows[row], 0, 16);
+        }
+    }
+    for (int row = 0; row < int(fixedCols.size()); ++row) {
+        if (fixedCols[row] >= 0) {
+            text += QString("q%1:%2;").arg(row).arg(fixedCols[row]);
+        }
+    }
+    return text;
+}
@@ -0,0 +1,41 @@
+#ifndef BOARDVARIANT_H
+#define BOARDVARIANT_H
+
+#include <QtGlobal>
+#include <QString>
+#include <vector>
+
+// Rules of the board being played. The solvers and the GUI conflict checks
+// both read this, so adding a variant only means teaching it here.
+struct BoardVariant {
+    bool toroidal = false;    // Diagonals wrap around the board edges
+    bool superqueens = false; // Queens also attack like knights (never wraps)
+
+    std::vector<quint64> blockedRows; // Per row, columns no queen may use (empty: none blocked)
+    std::vector<int> fixedCols;       // Per row, column of a pre-placed queen or -1 (empty: none fixed)
+
+    // Colored-regions puzzle: region (0..N-1) of every square, row * N + col (empty: no regions).
+    // One queen per row, column and region, no two queens touching, long diagonals don't count.
+    std::vector<int> regions;
+
+    bool isClassic() const;
+    bool attacks(int boardSize, int row1, int col1, int row2, int col2) const;
+    bool isBlocked(int row, int col) const;
+    int fixedCol(int row) const;
+    bool hasRegions() const;
+
+    // Known to have no solution without searching: toroidal boards need gcd(N, 6) == 1 (Polya),
+    // and superqueens, blocked squares and fixed queens only take solutions away
+    bool isUnsolvable(int boardSize) const;
+    int regionAt(int boardSize, int row, int col) const; // -1 without regions for this size
+    void setBlocked(int boardSize, int row, int col, bool blocked);
+    void setFixedQueen(int boardSize, int row, int col);
+
+    // Columns a queen may use on this row, before looking at other queens
+    quint64 allowedInRow(int row, quint64 full) const;
+
+    // Short stable description, e.g. to tell checkpoints of different variants apart
+    QString describe() const;
+};
+
+#endif // BOARDVARIANT_H
@@ -1,4 +1,6 @@
 #include "chessboard.h"
+#include "bitboard.h"
+#include "solverselector.h"
 
 #include <QMessageBox>
 #include <QGraphicsRectItem>
@@ -6,15 +8,20 @@
 #include <QTimer>
 #include <QPushButton>
 #include <QEventLoop>
-#include <QRandomGenerator>
+#include <QSignalBlocker>
+#include <QMouseEvent>
 #include <cmath>
+#include <algorithm>
 
 int SQUARE_SIZE = 100;
 
 ChessBoard::ChessBoard(QWidget *parent)
-    : QGraphicsView(parent), scene(new QGraphicsScene(this)), boardSize(8), elapsedSeconds(0) {
+    : QGraphicsView(parent), scene(new QGraphicsScene(this)), boardSize(8),
+      heatmap(nullptr), heatmapVisible(false), editingSquares(false), batchDepth(0), batchChanged(false),
+      highlights(scene), elapsedSeconds(0) {
     setScene(scene);
     setFixedSize(740, 740);
+    hintCache.setMaxCost(256); // Positions remembered for instant repeated hints
     scene->setSceneRect(0, 0, 580, 580);
 
     // Add a "Hint" button
@@ -41,7 +48,9 @@ void ChessBoard::setBoardSize(int newSize) {
     // THIS RESETs THE GAME
     clearQueens();       // Clear any existing queens
     boardSize = newSize; // Update internal board size
-    scene->clear();      // Clear the scene
+    hintCache.clear();   // Hints depend on the size and the rules
+    solutionIterator.reset();
+    clearScene();        // Clear the scene
     boardNeedsRedraw = true;
     drawBoard();         // Redraw the board
 
@@ -56,6 +65,19 @@ void ChessBoard::setBoardSize(int newSize) {
     }
 }
 
+int ChessBoard::getBoardSize() const {
+    return boardSize;
+}
+
+void ChessBoard::setVariant(const BoardVariant &newVariant) {
+    variant = newVariant;
+    setBoardSize(boardSize); // New rules, new game (also redraws blocked squares)
+}
+
+const BoardVariant &ChessBoard::getVariant() const {
+    return variant;
+}
+
 void ChessBoard::resetChronometer() {
     elapsedSeconds = 0;
     chronometerTimer->stop();
@@ -73,15 +95,24 @@ void ChessBoard::updateChronometer() {
 
 void ChessBoard::clearQueens() {
     for (Queen *queen : queens) {
+        if (heatmap) {
+            heatmap->removeQueen(queen->row(), queen->col());
+        }
         scene->removeItem(queen);
         delete queen;
     }
     queens.clear(); // kill the objects also
+    boardHash.reset();
+    if (batchDepth > 0) {
+        batchChanged = true;
+    }
 }
 
 void ChessBoard::resetGame() {
     queens.clear();
-    scene->clear();
+    boardHash.reset();
+    clearScene();
+    boardNeedsRedraw = true;
     drawBoard();
 }
 
@@ -91,8 +122,64 @@ void ChessBoard::addQueen(int row, int col) {
     scene->addItem(queen);
     queen->setZValue(2);  // Ensure queens stay above highlights and board
     queens.append(queen);
+    boardHash.toggle(row, col);
+    if (heatmap) {
+        heatmap->addQueen(row, col);
+    }
+
+    if (batchDepth > 0) {
+        batchChanged = true; // Announced once by commitBatch()
+    } else {
+        emit queenMoved();  // Notify listeners
+    }
+}
+
+void ChessBoard::beginBatch() {
+    if (batchDepth++ == 0) {
+        batchChanged = false;
+        viewport()->setUpdatesEnabled(false);
+    }
+}
+
+void ChessBoard::commitBatch() {
+    if (batchDepth == 0 || --batchDepth > 0) {
+        return;
+    }
+    viewport()->setUpdatesEnabled(true); // One repaint for the whole batch
+    if (batchChanged) {
+        emit queenMoved();
+    }
+}
+
+void ChessBoard::setPlacement(const HintEngine::Placement &placement) {
+    beginBatch();
+
+    // Queen items are reused, only the difference in count is created or deleted
+    while (queens.size() > int(placement.size())) {
+        Queen *queen = queens.takeLast();
+        boardHash.toggle(queen->row(), queen->col());
+        if (heatmap) {
+            heatmap->removeQueen(queen->row(), queen->col());
+        }
+        scene->removeItem(queen);
+        delete queen;
+    }
+    for (int index = 0; index < int(placement.size()); ++index) {
+        const int row = placement[index].first;
+        const int col = placement[index].second;
+        if (index < queens.size()) {
+            boardHash.move(queens[index]->row(), queens[index]->col(), row, col);
+            if (heatmap) {
+                heatmap->moveQueen(queens[index]->row(), queens[index]->col(), row, col);
+            }
+            queens[index]->setPosition(row, col);
+        } else {
+            addQueen(row, col);
+        }
+    }
 
-    emit queenMoved();  // Notify listeners
+    batchChanged = true;
+    commitBatch();
 }
 
 void ChessBoard::removeQueen(int row, int col) {
@@ -101,11 +188,77 @@ void ChessBoard::removeQueen(int row, int col) {
             scene->removeItem(queens[i]);
             delete queens[i];
             queens.removeAt(i);
+            boardHash.toggle(row, col);
+            if (heatmap) {
+                heatmap->removeQueen(row, col);
+            }
             return;
         }
     }
 }
 
+void ChessBoard::setHeatmapVisible(bool visible) {
+    heatmapVisible = visible;
+    if (heatmap) {
+        heatmap->setVisible(visible);
+    }
+}
+
+void ChessBoard::setEditingSquares(bool editing) {
+    editingSquares = editing;
+    if (editing) {
+        setBoardSize(boardSize); // Empty board, the queens come back with the next game
+    }
+}
+
+void ChessBoard::mousePressEvent(QMouseEvent *event) {
+    if (!editingSquares) {
+        QGraphicsView::mousePressEvent(event);
+        return;
+    }
+
+    const QPointF point = mapToScene(event->pos());
+    const int row = int(std::floor(point.y() / SQUARE_SIZE));
+    const int col = int(std::floor(point.x() / SQUARE_SIZE));
+    if (row < 0 || row >= boardSize || col < 0 || col >= boardSize) {
+        return;
+    }
+
+    // A square is either blocked or holds the fixed queen of its row, never both
+    BoardVariant edited = variant;
+    if (event->button() == Qt::RightButton) {
+        edited.setFixedQueen(boardSize, row, variant.fixedCol(row) == col ? -1 : col);
+        edited.setBlocked(boardSize, row, col, false);
+    } else {
+        edited.setBlocked(boardSize, row, col, !variant.isBlocked(row, col));
+        if (variant.fixedCol(row) == col) {
+            edited.setFixedQueen(boardSize, row, -1);
+        }
+    }
+    setVariant(edited);
+}
+
+void ChessBoard::rebuildHeatmap() {
+    if (!heatmap) {
+        return;
+    }
+    heatmap->clear();
+    for (Queen *queen : queens) {
+        heatmap->addQueen(queen->row(), queen->col());
+    }
+}
+
+void ChessBoard::onQueenMoved(int fromRow, int fromCol, int toRow, int toCol) {
+    boardHash.move(fromRow, fromCol, toRow, toCol);
+}
+
+void ChessBoard::onQueenDragged(int fromRow, int fromCol, int toRow, int toCol) {
+    // Only the dragged queen changes, so a couple of counter updates are enough
+    if (heatmap) {
+        heatmap->moveQueen(fromRow, fromCol, toRow, toCol);
+    }
+}
+
 void ChessBoard::onQueenDropped(int row, int col) {
     // Handle drag-and-drop for queens
     for (Queen *queen : queens) {
@@ -119,31 +272,30 @@ void ChessBoard::onQueenDropped(int row, int col) {
     }
 }
 
-bool ChessBoard::checkConflicts() {
-    bool conflictsFound = false;
-
-    // Reset tinting for all queens
-    for (Queen *queen : queens) {
-        QPixmap queenPixmap(":/resources/queen.png");
-        queen->setPixmap(queenPixmap.scaled(SQUARE_SIZE, SQUARE_SIZE));
+bool ChessBoard::updateConflictTint() {
+    if (!heatmap) {
+        boardNeedsRedraw = true;
+        drawBoard(); // Creates the heatmap from the queens
     }
 
-    // Check for conflicts between queens
-    for (int i = 0; i < queens.size(); ++i) {
-        for (int j = i + 1; j < queens.size(); ++j) {
-            Queen *q1 = queens[i];
-            Queen *q2 = queens[j];
-
-            if (q1->row() == q2->row() || q1->col() == q2->col() ||
-                std::abs(q1->row() - q2->row()) == std::abs(q1->col() - q2->col())) {
-                QPixmap queenPixmap(":/resources/queen.png");
-                q1->setPixmap(tintPixmap(queenPixmap.scaled(SQUARE_SIZE, SQUARE_SIZE), Qt::red));
-                q2->setPixmap(tintPixmap(queenPixmap.scaled(SQUARE_SIZE, SQUARE_SIZE), Qt::red));
+    // Every queen change updates the heatmap counters as it happens, so they already
+    // know who attacks what: O(queens) here, no rebuild and no comparing every pair
+    bool conflictsFound = false;
+    for (Queen *queen : queens) {
+        const int row = queen->row();
+        const int col = queen->col();
+        const bool conflicted = row < 0 || row >= boardSize || col < 0 || col >= boardSize || // Off the board
+                                heatmap->attackersAt(row, col) > 0 || heatmap->queensAt(row, col) > 1 ||
+                                variant.isBlocked(row, col) || // A queen on a blocked square is never valid
+                                (variant.fixedCol(row) >= 0 && variant.fixedCol(row) != col); // Nor off a fixed one
+        queen->setPixmap(queenPixmap(conflicted));
+        conflictsFound |= conflicted;
+    }
+    return conflictsFound;
+}
 
-                conflictsFound = true;
-            }
-        }
-    }
+bool ChessBoard::checkConflicts() {
+    bool conflictsFound = updateConflictTint();
 
     // Check if the puzzle is solved
     if (!conflictsFound) {
@@ -170,21 +322,24 @@ void ChessBoard::showHint() {
     drawBoard();
     checkConflicts();
 
-    QList<ChessBoard::Hint> hints;
-
-    for (Queen *queen : queens) {
-        if (isBlocking(queen)) {
-            QPair<int, int> safeMove = findSafeMoveForQueen(queen);
-            if (safeMove.first != -1 && safeMove.second != -1) {
-                hints.append({queen->row(), queen->col(), safeMove.first, safeMove.second, Qt::green, "Move this queen to a safe square."});
-                break; // Found a hint, no need to check other blocking queens for immediate moves.
-            }
-        }
-    }
-
-    if (hints.isEmpty()) {
-        if (  suggestLeastConflictMove(hints) || suggestFutureSafeMove(hints) || suggestConflictBreaker(hints) || suggestRandomMove(hints)) {
-            // A hint was found by one of the fallback methods
+    QList<Hint> hints;
+
+    // Same position as before (however it was reached): reuse its hint
+    HintEngine::Placement placement = currentPlacement();
+    std::sort(placement.begin(), placement.end());
+    CachedHint *cached = hintCache.object(boardHash.value());
+    if (cached && cached->placement == placement) {
+        hints.append(cached->hint);
+    } else {
+        // Safe move first, then the fallback strategies
+        hints = TaskScheduler::instance().runInteractive([size = boardSize, rules = variant, placement]() {
+            QList<Hint> found;
+            HintEngine engine(size, rules, placement);
+            engine.suggestHint(found);
+            return found;
+        });
+        if (!hints.isEmpty()) {
+            hintCache.insert(boardHash.value(), new CachedHint{placement, hints.first()});
         }
     }
 
@@ -226,6 +381,10 @@ void ChessBoard::performHintMove(int fromRow, int fromCol, int toRow, int toCol)
     for (Queen *queen : queens) {
         if (queen->row() == fromRow && queen->col() == fromCol) {
             queen->setPosition(toRow, toCol); // execute Hint suggestion
+            boardHash.move(fromRow, fromCol, toRow, toCol);
+            if (heatmap) {
+                heatmap->moveQueen(fromRow, fromCol, toRow, toCol);
+            }
             drawBoard();
             emit queenMoved();
             return;
@@ -238,325 +397,76 @@ void ChessBoard::drawBoard() {
     SQUARE_SIZE = squareSize;
 
     // Remove only highlights
-    QList<QGraphicsItem*> items = scene->items();
-    for (QGraphicsItem* item : items) {
-        if (item->zValue() == 1) {
-            scene->removeItem(item);
-            delete item;
-        }
-    }
+    highlights.clear();
 
     if (boardNeedsRedraw) {
-        scene->clear();
+        clearScene();
         for (int row = 0; row < boardSize; ++row) {
             for (int col = 0; col < boardSize; ++col) {
                 QGraphicsRectItem* square = scene->addRect(
                     col * squareSize, row * squareSize, squareSize, squareSize);
 
-                if ((row + col) % 2 == 0) {
+                int region = variant.regionAt(boardSize, row, col);
+                if (variant.isBlocked(row, col)) {
+                    square->setBrush(QBrush(Qt::black));
+                } else if (variant.fixedCol(row) == col) {
+                    square->setBrush(QBrush(QColor(218, 165, 32))); // Gold: a queen must stand here
+                } else if (region >= 0) {
+                    // Hues spread around the wheel, so neighbouring regions stay apart
+                    square->setBrush(QBrush(QColor::fromHsv(region * 360 / boardSize, 110, 235)));
+                } else if ((row + col) % 2 == 0) {
                     square->setBrush(QBrush(Qt::gray));
                 } else {
                     square->setBrush(QBrush(Qt::darkGray));
                 }
             }
         }
+
+        // Attack heatmap sits between the highlights (z 1) and the queens (z 2)
+        heatmap = new AttackHeatmap(boardSize, squareSize, variant);
+        heatmap->setZValue(1.5);
+        heatmap->setVisible(heatmapVisible);
+        scene->addItem(heatmap);
+        rebuildHeatmap();
+
         boardNeedsRedraw = false;
     }
 
     for (Queen* queen : queens) {
-        queen->setPixmap(QPixmap(":/resources/queen.png").scaled(SQUARE_SIZE, SQUARE_SIZE));
+        queen->setPixmap(queenPixmap());
         queen->setZValue(2);
         queen->setPosition(queen->row(), queen->col()); // Very important: position the queen
     }
 }
 
 
-void ChessBoard::highlightSquare(int row, int col, QColor color) {
-    int squareSize = SQUARE_SIZE;
-
-    QList<QGraphicsItem *> items = scene->items(QRectF(col * squareSize, row * squareSize, squareSize, squareSize));
-    for (QGraphicsItem *item : items) {
-        if (item->zValue() == 1 && scene->items().contains(item)) {
-            scene->removeItem(item);
-            delete item;
-        }
-    }
-
-    QGraphicsRectItem *highlight = scene->addRect(
-        col * squareSize, row * squareSize, squareSize, squareSize,
-        QPen(Qt::NoPen), QBrush(color.lighter(150)));
-    highlight->setZValue(1);
-}
-
-bool ChessBoard::suggestLeastConflictMove(QList<ChessBoard::Hint>& hints) {
-    int minConflicts = boardSize * boardSize;  // Initialize with a large value
-    QPair<int, int> bestMove = {-1, -1};
-    Queen* queenToMove = nullptr;
-
-   // Shuffle the queens list before iterating
-    QList<Queen*> shuffledQueens = queens;
-    std::random_device rd;   // Seed for randomness
-    std::mt19937 g(rd());    // Mersenne Twister PRNG
-    std::shuffle(shuffledQueens.begin(), shuffledQueens.end(), g);
-
-    for (Queen* queen : shuffledQueens) {
-        int originalRow = queen->row();
-        int originalCol = queen->col();
-
-        for (int targetRow = 0; targetRow < boardSize; ++targetRow) {
-            for (int targetCol = 0; targetCol < boardSize; ++targetCol) {
-                if (originalRow == targetRow && originalCol == targetCol) continue;
-
-                if ( !isQueenAt(targetRow, targetCol) ) {
-                    queen->setPosition(targetRow, targetCol);
-                } else continue;
-
-                int conflicts = calculateConflicts();
-                if (conflicts < minConflicts) {
-                    minConflicts = conflicts;
-                    bestMove = {targetRow, targetCol};
-                    queenToMove = queen;
-                }
-                queen->setPosition(originalRow, originalCol);
-            }
-        }
-    }
-
-    if (queenToMove && bestMove.first != -1) {
-        hints.append({queenToMove->row(), queenToMove->col(), bestMove.first, bestMove.second, Qt::yellow, "Move to reduce conflicts."});
-        return true;
-    }
-    return false;
-}
-
-int ChessBoard::calculateConflicts() {
-    int conflictCount = 0;
-    for (int i = 0; i < queens.size(); ++i) {
-        for (int j = i + 1; j < queens.size(); ++j) {
-            Queen* q1 = queens[i];
-            Queen* q2 = queens[j];
-            if (q1->row() == q2->row() || q1->col() == q2->col() ||
-                std::abs(q1->row() - q2->row()) == std::abs(q1->col() - q2->col())) {
-                ++conflictCount;
-            }
-        }
-    }
-    return conflictCount;
-}
-
-int ChessBoard::calculateConflictsAt(int row, int col) {
-    int conflictCount = 0;
-
-    for (Queen* queen : queens) {
-        // Skip the position itself (optional check for queens already there)
-        if (queen->row() == row && queen->col() == col) continue;
-
-        // Check for conflicts:
-        if (queen->row() == row || queen->col() == col || 
-            std::abs(queen->row() - row) == std::abs(queen->col() - col)) {
-            ++conflictCount;
-        }
-    }
-
-    return conflictCount;
-}
-
-
-bool ChessBoard::suggestConflictBreaker(QList<ChessBoard::Hint>& hints) {
-    Queen* mostConflictingQueen = findQueenWithMostConflicts();
-    if (!mostConflictingQueen) return false;
-
-    int originalRow = mostConflictingQueen->row();
-    int originalCol = mostConflictingQueen->col();
-
-    for (int targetRow = 0; targetRow < boardSize; ++targetRow) {
-        for (int targetCol = 0; targetCol < boardSize; ++targetCol) {
-            if (originalRow == targetRow && originalCol == targetCol) continue;
-
-            if ( !isQueenAt(targetRow, targetCol) ) {
-                mostConflictingQueen->setPosition(targetRow, targetCol);
-            } else continue;
-            
-            if (calculateConflicts() < calculateConflictsAt(originalRow, originalCol)) {
-                hints.append({originalRow, originalCol, targetRow, targetCol, Qt::magenta, "Move to reduce major conflicts."});
-                mostConflictingQueen->setPosition(originalRow, originalCol);
-                return true;
-            }
-        }
-    }
-    mostConflictingQueen->setPosition(originalRow, originalCol);
-    return false;
-}
-
-Queen* ChessBoard::findQueenWithMostConflicts() {
-    Queen* worstQueen = nullptr;
-    int maxConflicts = 0;
-
-    // Shuffle the queens list before iterating
-    QList<Queen*> shuffledQueens = queens;
-    std::random_device rd;   // Seed for randomness
-    std::mt19937 g(rd());    // Mersenne Twister PRNG
-    std::shuffle(shuffledQueens.begin(), shuffledQueens.end(), g);
-
-    for (Queen* queen : shuffledQueens) {
-        int conflicts = calculateConflictsForQueen(queen);
-        if (conflicts > maxConflicts) {
-            maxConflicts = conflicts;
-            worstQueen = queen;
-        }
-    }
-    return worstQueen;
-}
-
-int ChessBoard::calculateConflictsForQueen(Queen* targetQueen) {
-    int conflicts = 0;
-    for (Queen* otherQueen : queens) {
-        if (targetQueen == otherQueen) continue;
-
-        if (targetQueen->row() == otherQueen->row() || 
-            targetQueen->col() == otherQueen->col() || 
-            std::abs(targetQueen->row() - otherQueen->row()) == std::abs(targetQueen->col() - otherQueen->col())) {
-            ++conflicts;
-        }
-    }
-    return conflicts;
-}
-
-bool ChessBoard::suggestRandomMove(QList<ChessBoard::Hint>& hints) {
-    // Shuffle the queens list before iterating
-    QList<Queen*> shuffledQueens = queens;
-    std::random_device rd;   // Seed for randomness
-    std::mt19937 g(rd());    // Mersenne Twister PRNG
-    std::shuffle(shuffledQueens.begin(), shuffledQueens.end(), g);
-
-    for (Queen* queen : shuffledQueens) {
-        int targetRow = QRandomGenerator::global()->bounded(boardSize);
-        int targetCol = QRandomGenerator::global()->bounded(boardSize);
-
-        if (targetRow != queen->row() || targetCol != queen->col()) {
-            hints.append({queen->row(), queen->col(), targetRow, targetCol, Qt::blue, "Try this random move."});
-            return true;
-        }
-    }
-    return false;
-}
-
-
-
-bool ChessBoard::suggestFutureSafeMove(QList<ChessBoard::Hint>& hints) {
-    // Shuffle the queens list before iterating
-    QList<Queen*> shuffledQueens = queens;
-    std::random_device rd;   // Seed for randomness
-    std::mt19937 g(rd());    // Mersenne Twister PRNG
-    std::shuffle(shuffledQueens.begin(), shuffledQueens.end(), g);
-
-    for (Queen* queenToMove : shuffledQueens) {
-        if (!isBlocking(queenToMove)) continue;
-
-        int originalRow = queenToMove->row();
-        int originalCol = queenToMove->col();
-
-        for (int targetRow = 0; targetRow < boardSize; ++targetRow) {
-            for (int targetCol = 0; targetCol < boardSize; ++targetCol) {
-                if (originalRow == targetRow && originalCol == targetCol) continue;
-
-                if ( !isQueenAt(targetRow, targetCol) ) {
-                    queenToMove->setPosition(targetRow, targetCol);
-                    emit queenMoved();
-                    checkConflicts();
-                } else continue;
-
-                for (Queen* otherQueen : queens) {
-                    if (otherQueen == queenToMove) continue;
-
-                    QPair<int, int> safeMoveForOther = findSafeMoveForQueen(otherQueen);
-                    if (safeMoveForOther.first != -1) { // A safe move exists for the other queen
-                        hints.append({originalRow, originalCol, targetRow, targetCol, Qt::cyan, QString("Moving this queen might allow the queen at (%1,%2) to move to a safe square.").arg(otherQueen->row()).arg(otherQueen->col())});
-                        queenToMove->setPosition(originalRow, originalCol);
-                        emit queenMoved();
-                        return true; // Found one future move
-                    }
-                }
-
-                queenToMove->setPosition(originalRow, originalCol);
-                emit queenMoved();
-
-            }
-        }
-    }
-    return false;
+void ChessBoard::invalidateBoard() {
+    boardNeedsRedraw = true;
 }
 
-bool ChessBoard::canCreateFutureSafeMove(Queen *movedQueen) {
-    for (Queen *otherQueen : queens) {
-        if (movedQueen == otherQueen)
-            continue;
-
-        // Check if any position becomes safe for the other queen
-        for (int row = 0; row < boardSize; ++row) {
-            for (int col = 0; col < boardSize; ++col) {
-                if (isSquareSafe(otherQueen, row, col))
-                    return true;  // A future safe move is possible!!
-            }
-        }
-    }
-    return false;  // No future safe moves found
+void ChessBoard::highlightSquare(int row, int col, QColor color) {
+    highlights.highlight(row, col, color.lighter(150)); // Replaces any highlight already on the square
 }
 
-bool ChessBoard::isSquareSafe(Queen *ignoreQueen, int row, int col) {
+void ChessBoard::clearScene() {
+    // The queens outlive a redraw, everything else is rebuilt
     for (Queen *queen : queens) {
-        // Skip the given queen
-        if (queen == ignoreQueen)
-            continue;
-
-        // Check if any queen threatens the (row, col) position
-        if (queen->row() == row ||                        // Same row
-            queen->col() == col ||                        // Same column
-            std::abs(queen->row() - row) == std::abs(queen->col() - col)) {  // Same diagonal
-            return false;  // Conflict detected
-        }
+        scene->removeItem(queen);
     }
-    return true;  // The square is safe
-}
-
-
-
-bool ChessBoard::isBlocking(Queen *queen) {
-    for (Queen *otherQueen : queens) {
-        if (queen != otherQueen) {
-            if (queen->row() == otherQueen->row() ||    // Same row
-                queen->col() == otherQueen->col() ||    // Same column
-                std::abs(queen->row() - otherQueen->row()) == std::abs(queen->col() - otherQueen->col())) {  // Same diagonal
-                return true;  // There is a conflict :P
-            }
-        }
+    scene->clear();
+    for (Queen *queen : queens) {
+        scene->addItem(queen);
     }
-    return false;  // No conflict! :D
+    heatmap = nullptr;           // Deleted with the scene items
+    highlights.reset(boardSize); // Same for the pooled highlights
 }
 
-QPair<int, int> ChessBoard::findSafeMoveForQueen(Queen *queen) {
-    // Try to find a safe move for the given queen that will resolve its conflicts
-    for (int row = 0; row < boardSize; ++row) {
-        for (int col = 0; col < boardSize; ++col) {
-            // Check if the square is safe
-            bool safe = true;
-            for (Queen *otherQueen : queens) {
-                if (queen != otherQueen && 
-                    (otherQueen->row() == row || otherQueen->col() == col || 
-                    std::abs(otherQueen->row() - row) == std::abs(otherQueen->col() - col))) {
-                    safe = false;  // Conflict found
-                    break;
-                }
-            }
-
-            // If the square is safe and not the queen's current position, return it
-            if (safe && !(row == queen->row() && col == queen->col())) {
-                return QPair<int, int>(row, col);
-            }
-        }
+HintEngine::Placement ChessBoard::currentPlacement() const {
+    HintEngine::Placement placement;
+    for (const Queen *queen : queens) {
+        placement.push_back({queen->row(), queen->col()});
     }
-    // No safe move found
-    return QPair<int, int>(-1, -1);
+    return placement;
 }
 
 bool ChessBoard::isQueenAt(int row, int col) {
@@ -583,25 +493,23 @@ void ChessBoard::solvePuzzle() {
     }
 
     // Find a solution
-    std::vector<std::pair<int, int>> solution = findSolution();
+    bool gaveUp = false;
+    std::vector<std::pair<int, int>> solution = TaskScheduler::instance().runInteractive([this, &gaveUp]() {
+        return findSolution(&gaveUp);
+    });
 
-    // Create a vector to store coordinates of already existing queens on the board
-    std::vector<std::pair<int, int>> existingQueens;
-
-    // Iterate through the board to find existing queens and store their positions
-    for (int row = 0; row < boardSize; ++row) {
-        for (int col = 0; col < boardSize; ++col) {
-            if (isQueenAt(row, col)) {  // Check if there is a queen at this position
-                existingQueens.push_back({row, col});
-            }
-        }
-    }
+    // Coordinates of the queens already on the board, in board order
+    std::vector<std::pair<int, int>> existingQueens = currentPlacement();
+    std::sort(existingQueens.begin(), existingQueens.end());
 
     // Loop through the solution and "move" queens to their new positions
     for (size_t i = 0; i < solution.size(); ++i) {
         int row = solution[i].first;
         int col = solution[i].second;
 
+        // Swap as one batch, so listeners see a single change per step
+        beginBatch();
+
         // If there are queens already on the board, remove the last one
         if (!existingQueens.empty()) {
             // Get the last queen's position
@@ -618,6 +526,7 @@ void ChessBoard::solvePuzzle() {
 
         // Place the NEW queen in the current solution's position
         addQueen(row, col);
+        commitBatch();
 
         // Create a blocking delay of 500 ms for animation purposes
         QEventLoop loop;
@@ -637,47 +546,62 @@ void ChessBoard::solvePuzzle() {
             action->setEnabled(true);
         }
     }
-}
 
-std::vector<std::pair<int, int>> ChessBoard::findSolution() {
-    std::vector<std::pair<int, int>> solution;
-    std::vector<int> board(boardSize, -1);  // -1 means no queen is placed in that column
-    
-    if (solveBacktrack(board, 0, solution)) {
-        return solution;
+    // Variants make unsolvable boards common, say so instead of doing nothing
+    if (solution.empty()) {
+        QMessageBox::information(this, "Solve", gaveUp ? "No solution was found in time; this board may have none."
+                                                       : "This board has no solutions.");
     }
-    
-    return solution;  // Empty (if no solution found)
 }
 
-bool ChessBoard::solveBacktrack(std::vector<int>& board, int row, std::vector<std::pair<int, int>>& solution) {
-    if (row == boardSize) {
-        // If we reach the last row, (solution found)
-        for (int i = 0; i < boardSize; ++i) {
-            solution.push_back({i, board[i]});
-        }
-        return true;
-    }
-    
-    for (int col = 0; col < boardSize; ++col) {
-        if (isSafe(board, row, col)) {
-            board[row] = col;  // Place queen at (row, col)
-            if (solveBacktrack(board, row + 1, solution)) {  // Descent
-                return true;
-            }
-            board[row] = -1;  // Backtrackz
+quint64 ChessBoard::showNextSolution() {
+    if (variant.isUnsolvable(boardSize)) {
+        return 0; // The search would take hours to prove it
+    }
+    if (!solutionIterator) {
+        solutionIterator.reset(new SolutionIterator(boardSize, variant));
+    }
+
+    // Resume the suspended search on the pool, wrapping around after the last solution
+    SolutionIterator *iterator = solutionIterator.get();
+    std::vector<int> cols = TaskScheduler::instance().runInteractive([iterator]() {
+        std::vector<int> found;
+        if (!iterator->next(found)) {
+            iterator->reset();
+            iterator->next(found);
         }
+        return found;
+    });
+    if (cols.empty()) {
+        return 0;
+    }
+
+    // Browsing solutions is not solving the puzzle
+    HintEngine::Placement placement;
+    for (int row = 0; row < boardSize; ++row) {
+        placement.push_back({row, cols[row]});
     }
-    
-    return false;  // No safe position for the queen :(
+    showPlacement(placement);
+    return solutionIterator->yielded();
 }
 
-bool ChessBoard::isSafe(const std::vector<int>& board, int row, int col) {
-    for (int i = 0; i < row; ++i) {
-        int c = board[i];
-        if (c == col || std::abs(c - col) == std::abs(i - row)) {
-            return false;  // Conflict with another queen :(
-        }
+void ChessBoard::showPlacement(const HintEngine::Placement &placement) {
+    {
+        const QSignalBlocker blocker(this);
+        setPlacement(placement);
     }
-    return true;
-}
\ No newline at end of file
+    drawBoard();
+    updateConflictTint();
+}
+
+std::vector<std::pair<int, int>> ChessBoard::findSolution(bool *gaveUp) {
+    std::vector<std::pair<int, int>> solution;
+
+    // The selector picks the engine predicted fastest for this size and variant,
+    // moving on to the next one if it runs over its budget
+    std::vector<int> cols = SolverSelector::instance().solve(boardSize, variant, nullptr, gaveUp);
+    for (int row = 0; row < int(cols.size()); ++row) {
+        solution.push_back({row, cols[row]});
+    }
+    return solution;  // Empty (if no solution found)
+}
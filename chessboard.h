@@ -5,8 +5,16 @@
 #include <QGraphicsScene>
 #include <QMenuBar>
 #include <QLabel>
+#include <QCache>
 #include "utils.h"
 #include "queen.h"
+#include "boardvariant.h"
+#include "attackheatmap.h"
+#include "hintengine.h"
+#include "highlightlayer.h"
+#include "zobrist.h"
+#include "bitboard.h"
+#include "taskscheduler.h"
 
 class ChessBoard : public QGraphicsView {
     Q_OBJECT
@@ -15,16 +23,41 @@ public:
     explicit ChessBoard(QWidget *parent = nullptr);
 
     void setBoardSize(int size);
+    int getBoardSize() const;
+    void setVariant(const BoardVariant &variant); // Resets the game
+    const BoardVariant &getVariant() const;
     void drawBoard();
+    void invalidateBoard(); // The next drawBoard() rebuilds every square, the queens stay
     void addQueen(int row, int col);
+
+    // Queen changes between beginBatch() and commitBatch() emit nothing and paint nothing;
+    // the commit emits queenMoved once, so listeners do a single conflict pass. Batches nest.
+    void beginBatch();
+    void commitBatch();
+    void setPlacement(const HintEngine::Placement &placement); // Replaces all queens as one batch
+    void showPlacement(const HintEngine::Placement &placement); // Same, tinted but without queenMoved or congratulations
     bool checkConflicts();
     void solvePuzzle();
+    quint64 showNextSolution(); // Index (from 1) of the solution shown, 0 if there is none
     void resetGame();
     void clearQueens();
+    void setHeatmapVisible(bool visible);
+
+    // While editing, the board holds no queens: a left click blocks or unblocks a square,
+    // a right click fixes a queen there (or frees the row). Every change is a new variant.
+    void setEditingSquares(bool editing);
+
+    void onQueenDragged(int fromRow, int fromCol, int toRow, int toCol); // Called by Queen while dragging
+    void onQueenMoved(int fromRow, int fromCol, int toRow, int toCol);   // Called by Queen when dropped
+    void highlightSquare(int row, int col, QColor color);  // Helper function to highlight a square
+    HintEngine::Placement currentPlacement() const;         // (row, col) of every queen on the board
 
 signals:
     void queenMoved();  // Emitted whenever a queen is moved
 
+protected:
+    void mousePressEvent(QMouseEvent *event) override;
+
 private slots:
     void performHintMove(int fromRow, int fromCol, int toRow, int toCol);
 
@@ -32,42 +65,35 @@ private slots:
 private:
     QGraphicsScene *scene;
     int boardSize; // Dynamic board size
+    BoardVariant variant; // Rules shared by the conflict checks and the solver
     bool boardNeedsRedraw; // flag to only redraw squares if necessary
+    AttackHeatmap *heatmap; // Owned by the scene, recreated whenever the board is redrawn, updated with every queen change
+    bool heatmapVisible;
+    bool editingSquares;
+    void rebuildHeatmap(); // O(N^2), only for a new heatmap
+    int batchDepth;    // Open beginBatch() calls
+    bool batchChanged; // Queens changed since the outermost beginBatch()
+    bool updateConflictTint(); // Tints conflicting queens red, O(queens); true if any conflict
+    HighlightLayer highlights; // Hint highlights, indexed by square
+    void clearScene(); // scene->clear() plus forgetting the items it deleted
 
     QList<Queen *> queens;
     void onQueenDropped(int row, int col);
     bool isQueenAt(int row, int col);
     void removeQueen(int row, int col);
 
-    struct Hint {
-        int fromRow;
-        int fromCol;
-        int toRow;
-        int toCol;
-        QColor color;
-        QString description;
-    };
-
-
     void showHint();  // Show a hint "sound system" ye ! !!
-    int calculateConflicts();
-    int calculateConflictsAt(int row, int col);
-    bool suggestLeastConflictMove(QList<ChessBoard::Hint>& hints);
-    bool suggestConflictBreaker(QList<ChessBoard::Hint>& hints);
-    Queen* findQueenWithMostConflicts();
-    int calculateConflictsForQueen(Queen* targetQueen);
-    bool suggestRandomMove(QList<ChessBoard::Hint>& hints);
-    bool canCreateFutureSafeMove(Queen *movedQueen);
-    bool suggestFutureSafeMove(QList<ChessBoard::Hint>& hints);
-    QPair<int, int> findSafeMoveForQueen(Queen *queen);
-    bool isBlocking(Queen *queen);
-    bool isSquareSafe(Queen *ignoreQueen, int row, int col);
-        
-    std::vector<std::pair<int, int>> findSolution();
-    bool solveBacktrack(std::vector<int>& board, int row, std::vector<std::pair<int, int>>& solution);
-    bool isSafe(const std::vector<int>& board, int row, int col);
 
-    void highlightSquare(int row, int col, QColor color);  // Helper function to highlight a square
+    // Best hint per position, keyed by the Zobrist hash of the queens (LRU)
+    struct CachedHint {
+        HintEngine::Placement placement; // Sorted, guards against hash collisions
+        Hint hint;
+    };
+    ZobristHash boardHash; // Updated on every queen add, remove and move
+    QCache<quint64, CachedHint> hintCache;
+
+    std::unique_ptr<SolutionIterator> solutionIterator; // Where "Next Solution" is, restarted by every new game
+    std::vector<std::pair<int, int>> findSolution(bool *gaveUp = nullptr); // *gaveUp: empty, but not proven
 
     void resetChronometer();
     void updateChronometer();
@@ -0,0 +1,57 @@
+#include "highlightlayer.h"
+#include "utils.h"
+
+#include <QBrush>
+#include <QPen>
+
+HighlightLayer::HighlightLayer(QGraphicsScene *scene)
+    : scene(scene), boardSize(0) {
+}
+
+void HighlightLayer::reset(int newSize) {
+    boardSize = newSize;
+    bySquare.assign(boardSize * boardSize, nullptr);
+    activeSquares.clear();
+    pool.clear();
+}
+
+void HighlightLayer::highlight(int row, int col, const QColor &color) {
+    if (row < 0 || row >= boardSize || col < 0 || col >= boardSize) {
+        return;
+    }
+
+    const int square = row * boardSize + col;
+    QGraphicsRectItem *item = bySquare[square];
+
+    if (!item) {
+        if (pool.empty()) {
+            item = scene->addRect(QRectF(), QPen(Qt::NoPen));
+            item->setZValue(1); // Above the board squares, below the queens
+        } else {
+            item = pool.back();
+            pool.pop_back();
+        }
+        item->setRect(col * SQUARE_SIZE, row * SQUARE_SIZE, SQUARE_SIZE, SQUARE_SIZE);
+        item->show();
+        bySquare[square] = item;
+        activeSquares.push_back(square);
+    }
+
+    if (item->brush().color() != color) {
+        item->setBrush(color);
+    }
+}
+
+void HighlightLayer::clear() {
+    for (int square : activeSquares) {
+        QGraphicsRectItem *item = bySquare[square];
+        item->hide();
+        pool.push_back(item);
+        bySquare[square] = nullptr;
+    }
+    activeSquares.clear();
+}
+
+bool HighlightLayer::isHighlighted(int row, int col) const {
+    return row >= 0 && row < boardSize && col >= 0 && col < boardSize && bySquare[row * boardSize + col];
+}
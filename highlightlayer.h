@@ -0,0 +1,31 @@
+#ifndef HIGHLIGHTLAYER_H
+#define HIGHLIGHTLAYER_H
+
+#include <QGraphicsScene>
+#include <QGraphicsRectItem>
+#include <QColor>
+#include <vector>
+
+// Square highlights (hints) indexed by square, backed by a pool of reusable rect items.
+// Showing or clearing highlights is O(highlights) and, once the pool is warm, allocation free.
+class HighlightLayer {
+
+public:
+    explicit HighlightLayer(QGraphicsScene *scene);
+
+    // Forget every item, e.g. after QGraphicsScene::clear() deleted them
+    void reset(int boardSize);
+
+    void highlight(int row, int col, const QColor &color);
+    void clear();
+    bool isHighlighted(int row, int col) const;
+
+private:
+    QGraphicsScene *scene;
+    int boardSize;
+    std::vector<QGraphicsRectItem *> bySquare; // Visible highlight per square, or nullptr
+    std::vector<int> activeSquares;            // Squares with a visible highlight
+    std::vector<QGraphicsRectItem *> pool;     // Hidden items ready for reuse
+};
+
+#endif // HIGHLIGHTLAYER_H
@@ -0,0 +1,274 @@
+#include "hintengine.h"
+
+#include <algorithm>
+#include <numeric>
+
+HintEngine::HintEngine(int boardSize, const BoardVariant &variant, const Placement &queens, unsigned int seed)
+    : boardSize(boardSize), variant(variant), queens(queens), occupied(boardSize * boardSize, 0), rng(seed) {
+    for (const auto &queen : queens) {
+        if (isInside(queen.first, queen.second)) {
+            ++occupied[queen.first * boardSize + queen.second];
+        }
+    }
+}
+
+bool HintEngine::suggestHint(QList<Hint> &hints) {
+    if (suggestSafeMove(hints)) {
+        return true;
+    }
+    return suggestLeastConflictMove(hints) || suggestFutureSafeMove(hints) ||
+           suggestConflictBreaker(hints) || suggestRandomMove(hints);
+}
+
+bool HintEngine::suggestSafeMove(QList<Hint> &hints) {
+    for (int index = 0; index < int(queens.size()); ++index) {
+        if (isBlocking(index)) {
+            std::pair<int, int> safeMove = findSafeMoveForQueen(index);
+            if (safeMove.first != -1) {
+                hints.append({queens[index].first, queens[index].second, safeMove.first, safeMove.second,
+                              Qt::green, "Move this queen to a safe square.", "safe"});
+                return true; // Found a hint, no need to check other blocking queens
+            }
+        }
+    }
+    return false;
+}
+
+bool HintEngine::suggestLeastConflictMove(QList<Hint> &hints) {
+    int minConflicts = boardSize * boardSize;  // Initialize with a large value
+    int queenToMove = -1;
+    std::pair<int, int> bestMove = {-1, -1};
+
+    // Moving one queen only changes the pairs it is part of
+    const int totalConflicts = calculateConflicts();
+
+    for (int index : shuffledQueens()) {
+        const int originalRow = queens[index].first;
+        const int originalCol = queens[index].second;
+        const int ownConflicts = calculateConflictsForQueen(index);
+
+        for (int targetRow = 0; targetRow < boardSize; ++targetRow) {
+            for (int targetCol = 0; targetCol < boardSize; ++targetCol) {
+                if (originalRow == targetRow && originalCol == targetCol) continue;
+                if (isQueenAt(targetRow, targetCol) || variant.isBlocked(targetRow, targetCol)) continue;
+
+                int conflicts = totalConflicts - ownConflicts + calculateConflictsAt(targetRow, targetCol, index);
+                if (conflicts < minConflicts) {
+                    minConflicts = conflicts;
+                    bestMove = {targetRow, targetCol};
+                    queenToMove = index;
+                }
+            }
+        }
+    }
+
+    if (queenToMove != -1) {
+        hints.append({queens[queenToMove].first, queens[queenToMove].second, bestMove.first, bestMove.second,
+                      Qt::yellow, "Move to reduce conflicts.", "least-conflict"});
+        return true;
+    }
+    return false;
+}
+
+bool HintEngine::suggestConflictBreaker(QList<Hint> &hints) {
+    const int index = findQueenWithMostConflicts();
+    if (index == -1) return false;
+
+    const int originalRow = queens[index].first;
+    const int originalCol = queens[index].second;
+    const int totalConflicts = calculateConflicts();
+    const int ownConflicts = calculateConflictsForQueen(index);
+    const int conflictsLeftBehind = calculateConflictsAt(originalRow, originalCol, index);
+
+    for (int targetRow = 0; targetRow < boardSize; ++targetRow) {
+        for (int targetCol = 0; targetCol < boardSize; ++targetCol) {
+            if (originalRow == targetRow && originalCol == targetCol) continue;
+            if (isQueenAt(targetRow, targetCol) || variant.isBlocked(targetRow, targetCol)) continue;
+
+            int conflicts = totalConflicts - ownConflicts + calculateConflictsAt(targetRow, targetCol, index);
+            if (conflicts < conflictsLeftBehind) {
+                hints.append({originalRow, originalCol, targetRow, targetCol,
+                              Qt::magenta, "Move to reduce major conflicts.", "conflict-breaker"});
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool HintEngine::suggestFutureSafeMove(QList<Hint> &hints) {
+    for (int index : shuffledQueens()) {
+        if (!isBlocking(index)) continue;
+
+        const int originalRow = queens[index].first;
+        const int originalCol = queens[index].second;
+
+        for (int targetRow = 0; targetRow < boardSize; ++targetRow) {
+            for (int targetCol = 0; targetCol < boardSize; ++targetCol) {
+                if (originalRow == targetRow && originalCol == targetCol) continue;
+                if (isQueenAt(targetRow, targetCol) || variant.isBlocked(targetRow, targetCol)) continue;
+
+                setQueen(index, targetRow, targetCol);
+                for (int other = 0; other < int(queens.size()); ++other) {
+                    if (other == index) continue;
+
+                    if (findSafeMoveForQueen(other).first != -1) { // A safe move exists for the other queen
+                        hints.append({originalRow, originalCol, targetRow, targetCol, Qt::cyan,
+                                      QString("Moving this queen might allow the queen at (%1,%2) to move to a safe square.")
+                                      .arg(queens[other].first).arg(queens[other].second),
+                                      "future-safe"});
+                        setQueen(index, originalRow, originalCol);
+                        return true; // Found one future move
+                    }
+                }
+                setQueen(index, originalRow, originalCol);
+            }
+        }
+    }
+    return false;
+}
+
+bool HintEngine::suggestRandomMove(QList<Hint> &hints) {
+    std::uniform_int_distribution<int> square(0, boardSize - 1);
+
+    for (int index : shuffledQueens()) {
+        int targetRow = square(rng);
+        int targetCol = square(rng);
+
+        if (targetRow != queens[index].first || targetCol != queens[index].second) {
+            hints.append({queens[index].first, queens[index].second, targetRow, targetCol,
+                          Qt::blue, "Try this random move.", "random"});
+            return true;
+        }
+    }
+    return false;
+}
+
+int HintEngine::calculateConflicts() const {
+    int conflictCount = 0;
+    for (int i = 0; i < int(queens.size()); ++i) {
+        if (variant.isBlocked(queens[i].first, queens[i].second)) {
+            ++conflictCount;
+        }
+        for (int j = i + 1; j < int(queens.size()); ++j) {
+            if (attacks(queens[i].first, queens[i].second, queens[j].first, queens[j].second)) {
+                ++conflictCount;
+            }
+        }
+    }
+    return conflictCount;
+}
+
+void HintEngine::moveQueen(int fromRow, int fromCol, int toRow, int toCol) {
+    for (int index = 0; index < int(queens.size()); ++index) {
+        if (queens[index].first == fromRow && queens[index].second == fromCol) {
+            setQueen(index, toRow, toCol);
+            return;
+        }
+    }
+}
+
+const HintEngine::Placement &HintEngine::placement() const {
+    return queens;
+}
+
+bool HintEngine::attacks(int row1, int col1, int row2, int col2) const {
+    return variant.attacks(boardSize, row1, col1, row2, col2);
+}
+
+bool HintEngine::isInside(int row, int col) const {
+    return row >= 0 && row < boardSize && col >= 0 && col < boardSize;
+}
+
+bool HintEngine::isQueenAt(int row, int col) const {
+    return isInside(row, col) && occupied[row * boardSize + col] > 0;
+}
+
+void HintEngine::setQueen(int index, int row, int col) {
+    auto &queen = queens[index];
+    if (isInside(queen.first, queen.second)) {
+        --occupied[queen.first * boardSize + queen.second];
+    }
+    queen = {row, col};
+    if (isInside(row, col)) {
+        ++occupied[row * boardSize + col];
+    }
+}
+
+int HintEngine::calculateConflictsAt(int row, int col, int ignoreIndex) const {
+    int conflictCount = 0;
+    for (int index = 0; index < int(queens.size()); ++index) {
+        if (index == ignoreIndex) continue;
+        // Skip queens standing on the square itself
+        if (queens[index].first == row && queens[index].second == col) continue;
+
+        if (attacks(queens[index].first, queens[index].second, row, col)) {
+            ++conflictCount;
+        }
+    }
+    return conflictCount;
+}
+
+int HintEngine::calculateConflictsForQueen(int index) const {
+    int conflicts = variant.isBlocked(queens[index].first, queens[index].second) ? 1 : 0;
+    for (int other = 0; other < int(queens.size()); ++other) {
+        if (other == index) continue;
+
+        if (attacks(queens[index].first, queens[index].second, queens[other].first, queens[other].second)) {
+            ++conflicts;
+        }
+    }
+    return conflicts;
+}
+
+int HintEngine::findQueenWithMostConflicts() {
+    int worstQueen = -1;
+    int maxConflicts = 0;
+
+    for (int index : shuffledQueens()) {
+        int conflicts = calculateConflictsForQueen(index);
+        if (conflicts > maxConflicts) {
+            maxConflicts = conflicts;
+            worstQueen = index;
+        }
+    }
+    return worstQueen;
+}
+
+bool HintEngine::isBlocking(int index) const {
+    return calculateConflictsForQueen(index) > 0;
+}
+
+bool HintEngine::isSquareSafe(int ignoreIndex, int row, int col) const {
+    if (variant.isBlocked(row, col)) {
+        return false;
+    }
+    for (int index = 0; index < int(queens.size()); ++index) {
+        if (index == ignoreIndex) continue;
+
+        if (attacks(queens[index].first, queens[index].second, row, col)) {
+            return false;  // Conflict detected
+        }
+    }
+    return true;  // The square is safe
+}
+
+std::pair<int, int> HintEngine::findSafeMoveForQueen(int index) const {
+    for (int row = 0; row < boardSize; ++row) {
+        for (int col = 0; col < boardSize; ++col) {
+            if (row == queens[index].first && col == queens[index].second) continue;
+
+            if (isSquareSafe(index, row, col)) {
+                return {row, col};
+            }
+        }
+    }
+    return {-1, -1}; // No safe move found
+}
+
+std::vector<int> HintEngine::shuffledQueens() {
+    std::vector<int> order(queens.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), rng);
+    return order;
+}
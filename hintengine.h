@@ -0,0 +1,65 @@
+#ifndef HINTENGINE_H
+#define HINTENGINE_H
+
+#include <QColor>
+#include <QList>
+#include <QString>
+#include <random>
+#include <utility>
+#include <vector>
+#include "boardvariant.h"
+
+struct Hint {
+    int fromRow;
+    int fromCol;
+    int toRow;
+    int toCol;
+    QColor color;
+    QString description;
+    QString strategy; // Name of the strategy that found it
+};
+
+// The hint strategies, working on plain (row, col) placements instead of scene items,
+// so the GUI, the headless service and offline tools all share them.
+class HintEngine {
+
+public:
+    using Placement = std::vector<std::pair<int, int>>;
+
+    HintEngine(int boardSize, const BoardVariant &variant, const Placement &queens,
+               unsigned int seed = std::random_device()());
+
+    // Tries the strategies below in order, like the Hint button does
+    bool suggestHint(QList<Hint> &hints);
+
+    bool suggestSafeMove(QList<Hint> &hints);
+    bool suggestLeastConflictMove(QList<Hint> &hints);
+    bool suggestConflictBreaker(QList<Hint> &hints);
+    bool suggestFutureSafeMove(QList<Hint> &hints);
+    bool suggestRandomMove(QList<Hint> &hints);
+
+    int calculateConflicts() const; // Attacking pairs, plus queens on blocked squares
+    void moveQueen(int fromRow, int fromCol, int toRow, int toCol);
+    const Placement &placement() const;
+
+private:
+    int boardSize;
+    BoardVariant variant;
+    Placement queens;
+    std::vector<int> occupied; // Queens per square
+    std::mt19937 rng;
+
+    bool attacks(int row1, int col1, int row2, int col2) const;
+    bool isInside(int row, int col) const;
+    bool isQueenAt(int row, int col) const;
+    void setQueen(int index, int row, int col);
+    int calculateConflictsAt(int row, int col, int ignoreIndex) const;
+    int calculateConflictsForQueen(int index) const;
+    int findQueenWithMostConflicts();
+    bool isBlocking(int index) const;
+    bool isSquareSafe(int ignoreIndex, int row, int col) const;
+    std::pair<int, int> findSafeMoveForQueen(int index) const;
+    std::vector<int> shuffledQueens();
+};
+
+#endif // HINTENGINE_H
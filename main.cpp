@@ -1,7 +1,67 @@
 #include <QApplication>
+#include <QCoreApplication>
+#include <cstring>
+#include <iostream>
 #include "mainwindow.h"
+#include "batchservice.h"
+#include "placementio.h"
+#include "solverselector.h"
 
 int main(int argc, char *argv[]) {
+    // Headless modes, no widgets:
+    //   QtQueens --stdio            answer JSON-lines requests from stdin
+    //   QtQueens --serve <name>     answer JSON-lines requests on a local socket
+    //   QtQueens --validate <file>  check a placement file, exit code 0 if it is a solution
+    //   QtQueens --calibrate        time the solver engines and save the profile the solve path uses
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--validate") == 0 && i + 1 < argc) {
+            QCoreApplication app(argc, argv);
+            std::vector<quint32> cols;
+            QString error;
+            if (!PlacementFile::load(QString::fromLocal8Bit(argv[i + 1]), cols, &error)) {
+                std::cerr << qPrintable(error) << std::endl;
+                return 2;
+            }
+            PlacementCheck check = validatePlacement(cols);
+            std::cout << cols.size() << " queens: " << (check.isValid() ? "valid" : "invalid")
+                      << " (" << check.outOfRange << " off board, " << check.columnClashes << " column, "
+                      << check.diagonalClashes << " diagonal, " << check.antiDiagonalClashes
+                      << " anti-diagonal clashes)" << std::endl;
+            return check.isValid() ? 0 : 1;
+        }
+
+        if (std::strcmp(argv[i], "--calibrate") == 0) {
+            QCoreApplication app(argc, argv);
+            QString error;
+            if (!SolverSelector::instance().calibrate({}, &error)) {
+                std::cerr << qPrintable(error) << std::endl;
+                return 1;
+            }
+            std::cout << "Profile saved to " << qPrintable(SolverSelector::profilePath()) << std::endl;
+            for (int boardSize : {8, 16, 25, 32, 64}) {
+                std::cout << boardSize << ":";
+                for (SolverSelector::Engine engine : SolverSelector::instance().plan(boardSize, BoardVariant())) {
+                    std::cout << " " << qPrintable(SolverSelector::engineName(engine));
+                }
+                std::cout << std::endl;
+            }
+            return 0;
+        }
+
+        bool stdio = std::strcmp(argv[i], "--stdio") == 0;
+        bool serve = std::strcmp(argv[i], "--serve") == 0 && i + 1 < argc;
+        if (stdio || serve) {
+            QCoreApplication app(argc, argv);
+            BatchService service;
+            if (stdio) {
+                service.serveStdio();
+            } else if (!service.listen(QString::fromLocal8Bit(argv[i + 1]))) {
+                return 1;
+            }
+            return app.exec();
+        }
+    }
+
     QApplication app(argc, argv);
 
     MainWindow window;
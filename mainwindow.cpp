@@ -4,9 +4,27 @@
 #include <QMessageBox>
 #include <QApplication>
 #include <QVBoxLayout>
+#include <QProgressDialog>
+#include <QFileDialog>
+#include <QStandardPaths>
+#include <QDir>
+#include <QActionGroup>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QThread>
+#include <QSignalBlocker>
+#include <QFutureWatcher>
+#include <QEventLoop>
+#include <algorithm>
+#include "solutionenumerator.h"
+#include "placementio.h"
+#include "taskscheduler.h"
+#include "regionpuzzle.h"
+#include "solverselector.h"
 
 MainWindow::MainWindow(QWidget *parent)
-    : QMainWindow(parent), chessBoard(new ChessBoard(this)) {
+    : QMainWindow(parent), chessBoard(new ChessBoard(this)), difficulty(PuzzleGenerator::Medium),
+      regionsMode(false), enumerationProgress(nullptr), enumerationBoardSize(0) {
 
     // Set ChessBoard as the central widget
     setCentralWidget(chessBoard);
@@ -38,16 +56,119 @@ MainWindow::MainWindow(QWidget *parent)
     // Add "Set Board Size" Action
     actionSetBoardSize = new QAction("Set Board Size", this);
     QAction *solutionAction = new QAction("SOLUTION", this);
+    QAction *nextSolutionAction = new QAction("Next Solution", this);
+    QAction *countAction = new QAction("Count Solutions", this);
+    QAction *exportAllAction = new QAction("Export All Solutions...", this);
 
     menuOptions->addAction(actionSetBoardSize);
     menuOptions->addAction(solutionAction);
+    menuOptions->addAction(nextSolutionAction);
+    menuOptions->addAction(countAction);
+    menuOptions->addAction(exportAllAction);
+
+    QAction *importPlacementAction = menuOptions->addAction("Import Placement...");
+    QAction *exportPlacementAction = menuOptions->addAction("Export Placement...");
+    connect(importPlacementAction, &QAction::triggered, this, &MainWindow::importPlacement);
+    connect(exportPlacementAction, &QAction::triggered, this, &MainWindow::exportPlacement);
+
+    // Threads shared by hints, solving, new games and counting
+    QAction *coreBudgetAction = menuOptions->addAction("Set Core Budget...");
+    connect(coreBudgetAction, &QAction::triggered, this, [this]() {
+        bool ok;
+        int threads = QInputDialog::getInt(this, "Set Core Budget", "Worker threads:",
+                                           TaskScheduler::instance().coreBudget(), 1,
+                                           std::max(1, QThread::idealThreadCount()), 1, &ok);
+        if (ok) {
+            TaskScheduler::instance().setCoreBudget(threads);
+        }
+    });
+
+    QAction *calibrateAction = menuOptions->addAction("Calibrate Solvers...");
+    connect(calibrateAction, &QAction::triggered, this, &MainWindow::calibrateSolvers);
+
+    QAction *heatmapAction = menuOptions->addAction("Show Attack Heatmap");
+    heatmapAction->setCheckable(true);
+    connect(heatmapAction, &QAction::toggled, chessBoard, &ChessBoard::setHeatmapVisible);
+
+    // Difficulty submenu, changing it starts a new game
+    QMenu *menuDifficulty = menuOptions->addMenu("Difficulty");
+    QActionGroup *difficultyGroup = new QActionGroup(this);
+    for (PuzzleGenerator::Difficulty level : {PuzzleGenerator::Easy, PuzzleGenerator::Medium, PuzzleGenerator::Hard}) {
+        QAction *levelAction = menuDifficulty->addAction(PuzzleGenerator::difficultyName(level));
+        levelAction->setCheckable(true);
+        levelAction->setChecked(level == difficulty);
+        difficultyGroup->addAction(levelAction);
+
+        connect(levelAction, &QAction::triggered, this, [this, level]() {
+            difficulty = level;
+            int size = chessBoard->getBoardSize();
+            chessBoard->setBoardSize(size);
+            addQueens(size);
+        });
+    }
+
+    // Variant submenu, the rules are shared by the conflict checks and the solver
+    QMenu *menuVariant = menuOptions->addMenu("Variant");
+    toroidalAction = menuVariant->addAction("Toroidal diagonals");
+    superqueensAction = menuVariant->addAction("Superqueens (knight moves)");
+    for (QAction *variantAction : {toroidalAction, superqueensAction}) {
+        variantAction->setCheckable(true);
+        connect(variantAction, &QAction::toggled, this, [this]() {
+            BoardVariant variant = chessBoard->getVariant();
+            variant.toroidal = toroidalAction->isChecked();
+            variant.superqueens = superqueensAction->isChecked();
+
+            chessBoard->setVariant(variant); // Starts a new game
+            addQueens(chessBoard->getBoardSize());
+        });
+    }
+
+    // Blocked squares and fixed queens are drawn on an empty board, the game restarts when done
+    editSquaresAction = menuVariant->addAction("Edit Blocked Squares and Fixed Queens");
+    editSquaresAction->setCheckable(true);
+    connect(editSquaresAction, &QAction::toggled, this, [this](bool checked) {
+        chessBoard->setEditingSquares(checked);
+        if (checked) {
+            setWindowTitle("QtQueens - Left click blocks a square, right click fixes a queen");
+        } else {
+            addQueens(chessBoard->getBoardSize());
+        }
+    });
+    clearSquaresAction = menuVariant->addAction("Clear Blocked Squares and Fixed Queens");
+    connect(clearSquaresAction, &QAction::triggered, this, [this]() {
+        BoardVariant variant = chessBoard->getVariant();
+        variant.blockedRows.clear();
+        variant.fixedCols.clear();
+        chessBoard->setVariant(variant);
+        addQueens(chessBoard->getBoardSize());
+    });
+
+    // Colored regions replace the other rules, so they are switched off meanwhile
+    menuVariant->addSeparator();
+    regionsAction = menuVariant->addAction("Colored regions");
+    regionsAction->setCheckable(true);
+    connect(regionsAction, &QAction::toggled, this, [this](bool checked) {
+        regionsMode = checked;
+        for (QAction *variantAction : {toroidalAction, superqueensAction, editSquaresAction}) {
+            const QSignalBlocker blocker(variantAction);
+            variantAction->setChecked(false);
+            variantAction->setEnabled(!checked);
+        }
+        clearSquaresAction->setEnabled(!checked);
+        chessBoard->setEditingSquares(false);
+        if (!checked) {
+            chessBoard->setVariant(BoardVariant());
+        }
+        addQueens(chessBoard->getBoardSize());
+    });
 
     // Connect "Set Board Size" Action
     connect(actionSetBoardSize, &QAction::triggered, this, [this]() {
         bool ok;
+        const int maxSize = regionsMode ? RegionPuzzle::MAX_GAME_SIZE : 25;
         int size = QInputDialog::getInt(this, "Set Board Size",
-                                        "Enter board size (e.g., 8 for 8x8):",
-                                        8, 4, 25, 1, &ok); // Min: 4, Max: 25
+                                        QString("Enter board size (4 to %1):").arg(maxSize),
+                                        8, 4, maxSize, 1, &ok);
         if (ok) {
             chessBoard->setBoardSize(size); // Update board size
             addQueens(size);               // Dynamically add queens
@@ -56,6 +177,31 @@ MainWindow::MainWindow(QWidget *parent)
 
     connect(solutionAction, &QAction::triggered, this, &MainWindow::onSolvePuzzle);
 
+    // Steps through the solutions in order, each one resumes the previous search
+    nextSolutionAction->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_N));
+    connect(nextSolutionAction, &QAction::triggered, this, [this]() {
+        quint64 index = chessBoard->showNextSolution();
+        if (index == 0) {
+            QMessageBox::information(this, "Next Solution", "This board has no solutions.");
+            return;
+        }
+        setWindowTitle(QString("QtQueens - Solution %1").arg(index));
+    });
+
+    connect(countAction, &QAction::triggered, this, [this]() {
+        runEnumeration(QString());
+    });
+
+    connect(exportAllAction, &QAction::triggered, this, [this]() {
+        QString path = QFileDialog::getSaveFileName(this, "Export All Solutions",
+                                                    QString("queens-%1.txt").arg(chessBoard->getBoardSize()));
+        if (!path.isEmpty()) {
+            runEnumeration(path);
+        }
+    });
+
+    connect(&enumerationWatcher, &QFutureWatcher<bool>::finished, this, &MainWindow::onEnumerationBatchDone);
+
     // Connect the chessBoard's signals
     connect(chessBoard, &ChessBoard::queenMoved, this, [this]() {
         bool solved = chessBoard->checkConflicts();
@@ -65,17 +211,279 @@ MainWindow::MainWindow(QWidget *parent)
     addQueens(8);
 }
 
+MainWindow::~MainWindow() {
+    enumerationWatcher.waitForFinished();
+}
+
 void MainWindow::addQueens(int boardSize) {
-    chessBoard->clearQueens(); // Remove any existing queens
+    if (editSquaresAction->isChecked()) {
+        return; // The board stays empty until editing is done
+    }
+    if (regionsMode) {
+        startRegionsGame(boardSize);
+        return;
+    }
+
+    // The generator rates boards against classic solutions only
+    Puzzle puzzle;
+    if (chessBoard->getVariant().isClassic()) {
+        const int moves = PuzzleGenerator::movesFor(boardSize, difficulty);
+        puzzle = TaskScheduler::instance().runInteractive([boardSize, moves]() {
+            return PuzzleGenerator::generate(boardSize, moves);
+        });
+    }
+
+    if (puzzle.queens.empty()) {
+        // No rated puzzle for this size or variant, fall back to the diagonal (fixed queens stay put)
+        const BoardVariant &variant = chessBoard->getVariant();
+        HintEngine::Placement diagonal;
+        for (int i = 0; i < boardSize; ++i) {
+            diagonal.push_back({i, variant.fixedCol(i) >= 0 ? variant.fixedCol(i) : i});
+        }
+        chessBoard->setPlacement(diagonal);
+        setWindowTitle("QtQueens");
+        return;
+    }
+
+    chessBoard->setPlacement(puzzle.queens);
+    setWindowTitle(QString("QtQueens - %1 (solvable in %2 moves)")
+                   .arg(PuzzleGenerator::difficultyName(difficulty)).arg(puzzle.minMoves));
+}
+
+void MainWindow::startRegionsGame(int boardSize) {
+    if (boardSize > RegionPuzzle::MAX_GAME_SIZE) {
+        boardSize = RegionPuzzle::MAX_GAME_SIZE;
+        QMessageBox::information(this, "Colored regions",
+                                 QString("Colored regions go up to %1x%1, so the board was made smaller.").arg(boardSize));
+        chessBoard->setBoardSize(boardSize);
+    }
+
+    // Proving the layout unique takes up to half a second, the window keeps repainting meanwhile
+    RegionLayout layout = TaskScheduler::instance().runInteractive([boardSize]() {
+        return RegionPuzzle::generate(boardSize);
+    });
+    BoardVariant variant;
+    variant.regions = layout.regions;
+
+    chessBoard->setVariant(variant); // Starts a new game on the new layout
+    HintEngine::Placement diagonal;
     for (int i = 0; i < boardSize; ++i) {
-        chessBoard->addQueen(i, i); // Place queens initially along the diagonal
+        diagonal.push_back({i, i});
+    }
+    chessBoard->setPlacement(diagonal);
+    setWindowTitle(layout.unique ? "QtQueens - Colored regions (one solution)" : "QtQueens - Colored regions");
+}
+
+void MainWindow::resetToClassic() {
+    for (QAction *variantAction : {toroidalAction, superqueensAction, regionsAction, editSquaresAction}) {
+        const QSignalBlocker blocker(variantAction);
+        variantAction->setChecked(false);
+        variantAction->setEnabled(true);
     }
+    clearSquaresAction->setEnabled(true);
+    regionsMode = false;
+    chessBoard->setEditingSquares(false);
+    chessBoard->setVariant(BoardVariant());
 }
 
 void MainWindow::onSolvePuzzle() {
     chessBoard->solvePuzzle();  // Call the solvePuzzle function of ChessBoard
 }
 
+void MainWindow::runEnumeration(const QString &outputPath) {
+    if (enumerator) {
+        QMessageBox::information(this, "Enumeration", "Another enumeration is running. Pause it or wait for it to finish.");
+        return;
+    }
+    const int boardSize = chessBoard->getBoardSize();
+
+    // Counting runs checkpoint into the app data dir, exports next to their output file
+    QString checkpointPath = outputPath + ".checkpoint";
+    if (outputPath.isEmpty()) {
+        QDir dataDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation));
+        dataDir.mkpath(".");
+        checkpointPath = dataDir.filePath(QString("count-%1.checkpoint").arg(boardSize));
+    }
+
+    enumerator = std::make_unique<SolutionEnumerator>(boardSize, checkpointPath, outputPath, chessBoard->getVariant());
+    if (!enumerator->start()) {
+        QMessageBox::warning(this, "Enumeration failed", enumerator->errorString());
+        enumerator.reset();
+        return;
+    }
+    enumerationBoardSize = boardSize;
+
+    // Not modal: the board stays playable while the pool counts at background priority
+    enumerationProgress = new QProgressDialog(this);
+    enumerationProgress->setWindowTitle(enumerator->wasResumed() ? "Resuming enumeration" : "Enumerating solutions");
+    enumerationProgress->setCancelButtonText("Pause");
+    enumerationProgress->setRange(0, enumerator->totalUnits());
+    enumerationProgress->setMinimumDuration(0);
+    enumerationProgress->setValue(enumerator->totalUnits() - enumerator->remainingUnits());
+    runEnumerationBatch();
+}
+
+void MainWindow::runEnumerationBatch() {
+    SolutionEnumerator *running = enumerator.get();
+    enumerationWatcher.setFuture(TaskScheduler::instance().run(TaskScheduler::Background, [running]() {
+        return running->processNextUnits();
+    }));
+}
+
+void MainWindow::onEnumerationBatchDone() {
+    const bool more = enumerationWatcher.result();
+    if (more) {
+        enumerationProgress->setLabelText(QString("%1 solutions found so far on the %2x%2 board")
+                                          .arg(enumerator->solutionCount()).arg(enumerationBoardSize));
+        enumerationProgress->setValue(enumerator->totalUnits() - enumerator->remainingUnits());
+        if (!enumerationProgress->wasCanceled()) {
+            runEnumerationBatch();
+            return;
+        }
+    }
+
+    // The run is over before any message box opens, so a new one may start from there
+    std::unique_ptr<SolutionEnumerator> done = std::move(enumerator);
+    enumerationProgress->deleteLater();
+    enumerationProgress = nullptr;
+
+    if (more) {
+        if (done->saveCheckpoint()) {
+            QMessageBox::information(this, "Enumeration paused",
+                                     "Progress was saved. Run it again to continue where it stopped.");
+        } else {
+            QMessageBox::warning(this, "Enumeration failed", done->errorString());
+        }
+        return;
+    }
+
+    if (!done->isFinished()) {
+        QMessageBox::warning(this, "Enumeration failed", done->errorString());
+        return;
+    }
+
+    QMessageBox::information(this, "Solutions",
+                             QString("The %1x%1 board has %2 solutions.").arg(enumerationBoardSize).arg(done->solutionCount()));
+}
+
+void MainWindow::calibrateSolvers() {
+    QProgressDialog progress("Timing the solver engines on this machine...", QString(), 0, 1, this);
+    progress.setWindowTitle("Calibrate Solvers");
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(0);
+
+    // Measured on a pool thread; progress comes back through the event loop
+    QString error;
+    QFutureWatcher<bool> watcher;
+    QEventLoop loop;
+    connect(&watcher, &QFutureWatcher<bool>::finished, &loop, &QEventLoop::quit);
+    watcher.setFuture(TaskScheduler::instance().run(TaskScheduler::Normal, [&progress, &error]() {
+        return SolverSelector::instance().calibrate([&progress](int done, int total) {
+            QMetaObject::invokeMethod(&progress, [&progress, done, total]() {
+                progress.setMaximum(total);
+                progress.setValue(done);
+            }, Qt::QueuedConnection);
+        }, &error);
+    }));
+    loop.exec();
+    progress.setValue(progress.maximum());
+
+    if (!watcher.result()) {
+        QMessageBox::warning(this, "Calibration failed",
+                             "The measurements are used until QtQueens quits, but could not be saved: " + error);
+        return;
+    }
+
+    // What the solver would now try for the current board, in order
+    const int boardSize = chessBoard->getBoardSize();
+    const BoardVariant &variant = chessBoard->getVariant();
+    QStringList order;
+    for (SolverSelector::Engine engine : SolverSelector::instance().plan(boardSize, variant)) {
+        order << QString("%1 (%2 ms)").arg(SolverSelector::engineName(engine))
+                                      .arg(SolverSelector::instance().predictedMs(engine, boardSize, variant), 0, 'g', 3);
+    }
+    QMessageBox::information(this, "Calibrate Solvers",
+                             QString("Profile saved to %1.\n\nOn the %2x%2 board the solver tries: %3.")
+                             .arg(SolverSelector::profilePath()).arg(boardSize).arg(order.join(", ")));
+}
+
+void MainWindow::importPlacement() {
+    QString path = QFileDialog::getOpenFileName(this, "Import Placement", QString(),
+                                                "Placements (*.qqp *.txt);;All files (*)");
+    if (path.isEmpty()) {
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    std::vector<quint32> cols;
+    QString error;
+    if (!PlacementFile::load(path, cols, &error)) {
+        QMessageBox::warning(this, "Import failed", error);
+        return;
+    }
+    const qint64 loadMs = timer.restart();
+    const PlacementCheck check = validatePlacement(cols);
+    const qint64 validateMs = timer.elapsed();
+
+    QString report = QString("%1 queens, loaded in %2 ms and checked in %3 ms.\n\n").arg(cols.size()).arg(loadMs).arg(validateMs);
+    if (check.isValid()) {
+        report += "This is a valid solution.";
+    } else {
+        report += QString("Not a solution: %1 off the board, %2 column, %3 diagonal and %4 anti-diagonal clashes.")
+                  .arg(check.outOfRange).arg(check.columnClashes)
+                  .arg(check.diagonalClashes).arg(check.antiDiagonalClashes);
+    }
+
+    // Only boards the Set Board Size dialog allows are drawn, bigger ones are just checked
+    const int boardSize = int(cols.size());
+    if (boardSize < 4 || boardSize > 25 || check.outOfRange > 0) {
+        QMessageBox::information(this, "Placement", report);
+        return;
+    }
+
+    // The file was checked against the classic rules, so that is what the board shows it with
+    if (!chessBoard->getVariant().isClassic() || regionsMode || editSquaresAction->isChecked()) {
+        resetToClassic();
+    }
+    chessBoard->setBoardSize(boardSize);
+    HintEngine::Placement placement;
+    for (int row = 0; row < boardSize; ++row) {
+        placement.push_back({row, int(cols[row])});
+    }
+    chessBoard->showPlacement(placement); // Shown and tinted, a valid file is not a solved game
+    setWindowTitle("QtQueens - " + QFileInfo(path).fileName());
+    QMessageBox::information(this, "Placement", report);
+}
+
+void MainWindow::exportPlacement() {
+    // The file formats hold one queen per row
+    const int boardSize = chessBoard->getBoardSize();
+    std::vector<quint32> cols(boardSize, 0);
+    std::vector<bool> rowUsed(boardSize, false);
+    const HintEngine::Placement placement = chessBoard->currentPlacement();
+    for (const auto &queen : placement) {
+        if (rowUsed[queen.first]) {
+            break;
+        }
+        rowUsed[queen.first] = true;
+        cols[queen.first] = quint32(queen.second);
+    }
+    if (int(placement.size()) != boardSize || std::find(rowUsed.begin(), rowUsed.end(), false) != rowUsed.end()) {
+        QMessageBox::warning(this, "Export Placement", "Only boards with exactly one queen in every row can be exported.");
+        return;
+    }
+
+    QString path = QFileDialog::getSaveFileName(this, "Export Placement",
+                                                QString("placement-%1.qqp").arg(boardSize),
+                                                "Binary placement (*.qqp);;Text placement (*.txt)");
+    QString error;
+    if (!path.isEmpty() && !PlacementFile::save(path, cols, &error)) {
+        QMessageBox::warning(this, "Export failed", error);
+    }
+}
+
 // 4. Define the About QtQueens Dialog
 void MainWindow::showAboutQtQueensDialog() {
     // Create dialog
@@ -5,13 +5,20 @@
 #include <QMenuBar>
 #include <QMenu>
 #include <QAction>
+#include <QFutureWatcher>
+#include <memory>
 #include "chessboard.h"
+#include "puzzlegenerator.h"
+#include "solutionenumerator.h"
+
+class QProgressDialog;
 
 class MainWindow : public QMainWindow {
     Q_OBJECT
 
 public:
     explicit MainWindow(QWidget *parent = nullptr);
+    ~MainWindow(); // Waits for the running enumeration batch, which then checkpoints
 
 public slots:
     void onSolvePuzzle();
@@ -22,8 +29,31 @@ private:
     QAction *actionSetBoardSize; // Action to set board size
 
     ChessBoard *chessBoard;  // The chessboard widget
-
-    void addQueens(int boardSize);
+    PuzzleGenerator::Difficulty difficulty; // Difficulty of new games
+    bool regionsMode; // New games are colored-regions puzzles
+
+    // Variant menu
+    QAction *toroidalAction;
+    QAction *superqueensAction;
+    QAction *regionsAction;
+    QAction *editSquaresAction; // Checked while blocked squares and fixed queens are being edited
+    QAction *clearSquaresAction;
+    void resetToClassic(); // Classic rules and Variant menu, without starting a new game
+
+    void addQueens(int boardSize); // Start a new game of the current difficulty
+    void startRegionsGame(int boardSize);
+    void runEnumeration(const QString &outputPath); // Count or export all solutions, resumable
+
+    // The running Count Solutions / Export All Solutions, one batch of work units at a time on the pool
+    std::unique_ptr<SolutionEnumerator> enumerator;
+    QFutureWatcher<bool> enumerationWatcher;
+    QProgressDialog *enumerationProgress;
+    int enumerationBoardSize;
+    void runEnumerationBatch();
+    void onEnumerationBatchDone(); // Next batch, or the result once finished, paused or failed
+    void importPlacement();  // Validate a placement file, and show it if it fits on the board
+    void exportPlacement();
+    void calibrateSolvers(); // Time the solver engines on this machine for the solve path
 
     void showAboutQtQueensDialog();
 };
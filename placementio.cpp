@@ -0,0 +1,235 @@
+#include "placementio.h"
+#include "taskscheduler.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QtEndian>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace {
+
+const char BINARY_MAGIC[4] = {'Q', 'Q', 'P', 'L'};
+const quint32 BINARY_VERSION = 1;
+const qint64 BINARY_HEADER_SIZE = 16;
+
+void setError(QString *error, const QString &message) {
+    if (error) {
+        *error = message;
+    }
+}
+
+bool isSpace(uchar c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+int decimalDigits(quint32 value) {
+    int digits = 1;
+    while (value >= 10) {
+        value /= 10;
+        ++digits;
+    }
+    return digits;
+}
+
+bool loadBinary(const uchar *data, qint64 size, std::vector<quint32> &cols, QString *error) {
+    if (size < BINARY_HEADER_SIZE || std::memcmp(data, BINARY_MAGIC, 4) != 0) {
+        setError(error, "Not a QtQueens placement file");
+        return false;
+    }
+    if (qFromLittleEndian<quint32>(data + 4) != BINARY_VERSION) {
+        setError(error, "Unsupported placement file version");
+        return false;
+    }
+
+    const quint64 count = qFromLittleEndian<quint64>(data + 8);
+    if (quint64(size - BINARY_HEADER_SIZE) / 4 != count || (size - BINARY_HEADER_SIZE) % 4 != 0) {
+        setError(error, "Placement file is truncated or has trailing data");
+        return false;
+    }
+
+    cols.resize(count);
+    const uchar *values = data + BINARY_HEADER_SIZE;
+    for (quint64 row = 0; row < count; ++row) {
+        cols[row] = qFromLittleEndian<quint32>(values + 4 * row);
+    }
+    return true;
+}
+
+bool loadText(const uchar *data, qint64 size, std::vector<quint32> &cols, QString *error) {
+    // First pass counts the numbers, so the column array is allocated exactly once
+    quint64 count = 0;
+    bool inNumber = false;
+    for (qint64 i = 0; i < size; ++i) {
+        if (data[i] >= '0' && data[i] <= '9') {
+            count += inNumber ? 0 : 1;
+            inNumber = true;
+        } else if (isSpace(data[i])) {
+            inNumber = false;
+        } else {
+            setError(error, QString("Unexpected character at byte %1").arg(i));
+            return false;
+        }
+    }
+
+    cols.clear();
+    cols.reserve(count);
+    quint64 value = 0;
+    inNumber = false;
+    for (qint64 i = 0; i <= size; ++i) {
+        if (i < size && data[i] >= '0' && data[i] <= '9') {
+            value = value * 10 + (data[i] - '0');
+            if (value > 0xffffffffULL) {
+                setError(error, QString("Column too large at byte %1").arg(i));
+                return false;
+            }
+            inNumber = true;
+        } else if (inNumber) {
+            cols.push_back(quint32(value));
+            value = 0;
+            inNumber = false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+PlacementFile::Format PlacementFile::formatForPath(const QString &path) {
+    return QFileInfo(path).suffix().compare("qqp", Qt::CaseInsensitive) == 0 ? Binary : Text;
+}
+
+bool PlacementFile::load(const QString &path, std::vector<quint32> &cols, QString *error) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        setError(error, file.errorString());
+        return false;
+    }
+
+    const qint64 size = file.size();
+    if (size == 0 && formatForPath(path) == Text) {
+        cols.clear(); // An empty board
+        return true;
+    }
+    if (size < BINARY_HEADER_SIZE && formatForPath(path) == Binary) {
+        setError(error, "Not a QtQueens placement file");
+        return false;
+    }
+
+    const uchar *data = file.map(0, size);
+    if (!data) {
+        setError(error, file.errorString());
+        return false;
+    }
+
+    bool ok = formatForPath(path) == Binary ? loadBinary(data, size, cols, error)
+                                            : loadText(data, size, cols, error);
+    file.unmap(const_cast<uchar *>(data));
+    return ok;
+}
+
+bool PlacementFile::save(const QString &path, const std::vector<quint32> &cols, QString *error) {
+    const Format format = formatForPath(path);
+
+    // Exact size first, so the file can be mapped once and filled in place
+    qint64 size = BINARY_HEADER_SIZE + 4 * qint64(cols.size());
+    if (format == Text) {
+        size = 0;
+        for (quint32 col : cols) {
+            size += decimalDigits(col) + 1; // Digits and a newline
+        }
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadWrite | QIODevice::Truncate) || !file.resize(size)) {
+        setError(error, file.errorString());
+        return false;
+    }
+    if (size == 0) {
+        return true;
+    }
+
+    uchar *data = file.map(0, size);
+    if (!data) {
+        setError(error, file.errorString());
+        return false;
+    }
+
+    if (format == Binary) {
+        std::memcpy(data, BINARY_MAGIC, 4);
+        qToLittleEndian<quint32>(BINARY_VERSION, data + 4);
+        qToLittleEndian<quint64>(cols.size(), data + 8);
+        for (size_t row = 0; row < cols.size(); ++row) {
+            qToLittleEndian<quint32>(cols[row], data + BINARY_HEADER_SIZE + 4 * row);
+        }
+    } else {
+        uchar *out = data;
+        for (quint32 col : cols) {
+            const int length = decimalDigits(col);
+            for (int digit = length - 1; digit >= 0; --digit) {
+                out[digit] = uchar('0' + col % 10);
+                col /= 10;
+            }
+            out[length] = '\n';
+            out += length + 1;
+        }
+    }
+
+    file.unmap(data);
+    return true;
+}
+
+PlacementCheck validatePlacement(const std::vector<quint32> &cols) {
+    const quint64 boardSize = cols.size();
+    PlacementCheck check;
+    if (boardSize == 0) {
+        return check;
+    }
+
+    // One "seen" bit per column and per diagonal, shared by all threads
+    const quint64 diagonals = 2 * boardSize - 1;
+    std::vector<std::atomic<quint64>> seenCols((boardSize + 63) / 64);
+    std::vector<std::atomic<quint64>> seenDiagonals((diagonals + 63) / 64);
+    std::vector<std::atomic<quint64>> seenAntiDiagonals((diagonals + 63) / 64);
+
+    std::atomic<quint64> outOfRange{0};
+    std::atomic<quint64> columnClashes{0};
+    std::atomic<quint64> diagonalClashes{0};
+    std::atomic<quint64> antiDiagonalClashes{0};
+
+    // A bit that was already set means an earlier queen is on the same line
+    auto markSeen = [](std::vector<std::atomic<quint64>> &seen, quint64 index) {
+        const quint64 bit = quint64(1) << (index % 64);
+        return (seen[index / 64].fetch_or(bit, std::memory_order_relaxed) & bit) != 0;
+    };
+
+    const quint64 chunkCount = std::min<quint64>(boardSize, quint64(TaskScheduler::instance().coreBudget()) * 4);
+    TaskScheduler::instance().blockingFor(int(chunkCount), TaskScheduler::Interactive, [&](int chunk) {
+        const quint64 first = boardSize * chunk / chunkCount;
+        const quint64 last = boardSize * (chunk + 1) / chunkCount;
+        quint64 local[4] = {0, 0, 0, 0};
+
+        for (quint64 row = first; row < last; ++row) {
+            const quint64 col = cols[row];
+            if (col >= boardSize) {
+                ++local[0];
+                continue;
+            }
+            local[1] += markSeen(seenCols, col);
+            local[2] += markSeen(seenDiagonals, row + col);
+            local[3] += markSeen(seenAntiDiagonals, row + boardSize - 1 - col);
+        }
+
+        outOfRange += local[0];
+        columnClashes += local[1];
+        diagonalClashes += local[2];
+        antiDiagonalClashes += local[3];
+    });
+
+    check.outOfRange = outOfRange;
+    check.columnClashes = columnClashes;
+    check.diagonalClashes = diagonalClashes;
+    check.antiDiagonalClashes = antiDiagonalClashes;
+    return check;
+}
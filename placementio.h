@@ -0,0 +1,39 @@
+#ifndef PLACEMENTIO_H
+#define PLACEMENTIO_H
+
+#include <QtGlobal>
+#include <QString>
+#include <vector>
+
+// A placement is one queen per row: cols[row] is the column of that row's queen.
+//
+// Files are read and written through QFile::map, so even million-queen boards
+// cost one allocation for the column array and nothing per queen.
+//   Binary (.qqp): "QQPL", quint32 version 1, quint64 N, then N quint32 columns, little endian
+//   Text (anything else): the N columns as decimal numbers separated by whitespace,
+//   e.g. one solution line as written by "Export All Solutions"
+namespace PlacementFile {
+
+enum Format { Binary, Text };
+
+Format formatForPath(const QString &path);
+bool load(const QString &path, std::vector<quint32> &cols, QString *error = nullptr);
+bool save(const QString &path, const std::vector<quint32> &cols, QString *error = nullptr);
+
+} // namespace PlacementFile
+
+struct PlacementCheck {
+    quint64 outOfRange = 0;           // Columns outside the board
+    quint64 columnClashes = 0;        // Queens sharing a column with an earlier one
+    quint64 diagonalClashes = 0;      // ... a row + col diagonal
+    quint64 antiDiagonalClashes = 0;  // ... a row - col diagonal
+
+    bool isValid() const {
+        return outOfRange == 0 && columnClashes == 0 && diagonalClashes == 0 && antiDiagonalClashes == 0;
+    }
+};
+
+// O(N) check with one "seen" bit per column and diagonal, rows split across the thread pool
+PlacementCheck validatePlacement(const std::vector<quint32> &cols);
+
+#endif // PLACEMENTIO_H
@@ -0,0 +1,189 @@
+#include "puzzlegenerator.h"
+#include "bitboard.h"
+#include "solutionsampler.h"
+#include "taskscheduler.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+namespace {
+
+// Branch and bound for the solution sharing the most squares with a placement
+struct OverlapSearch {
+    int boardSize;
+    quint64 full;
+    std::vector<quint64> placedInRow;   // Columns of the placed queens, per row
+    std::vector<int> rowsLeftWithQueens; // Rows from here down that hold a placed queen
+    int best;
+    quint64 nodes;
+    quint64 nodeBudget;
+
+    bool search(int row, quint64 cols, quint64 diag1, quint64 diag2, int overlap) {
+        if (++nodes > nodeBudget) {
+            return false;
+        }
+        if (row == boardSize) {
+            best = std::max(best, overlap);
+            return true;
+        }
+        if (overlap + rowsLeftWithQueens[row] <= best) {
+            return true; // Can't beat what we already have
+        }
+
+        const quint64 available = full & ~(cols | diag1 | diag2);
+
+        // Try the placed queens first, they lead to good bounds quickly
+        for (int pass = 0; pass < 2; ++pass) {
+            quint64 candidates = pass == 0 ? (available & placedInRow[row]) : (available & ~placedInRow[row]);
+            if (pass == 1 && overlap + rowsLeftWithQueens[row + 1] <= best) {
+                return true;
+            }
+            while (candidates) {
+                quint64 bit = candidates & (~candidates + 1);
+                candidates ^= bit;
+                if (!search(row + 1, cols | bit, ((diag1 | bit) << 1) & full, (diag2 | bit) >> 1,
+                            overlap + (pass == 0 ? 1 : 0))) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+};
+
+} // namespace
+
+int PuzzleGenerator::movesFor(int boardSize, Difficulty difficulty) {
+    switch (difficulty) {
+    case Easy:
+        return std::max(1, boardSize / 4);
+    case Medium:
+        return std::max(2, boardSize / 3);
+    case Hard:
+    default:
+        // Random boards are rarely more than about N/2 moves from the nearest solution
+        return std::max(3, boardSize / 2);
+    }
+}
+
+QString PuzzleGenerator::difficultyName(Difficulty difficulty) {
+    switch (difficulty) {
+    case Easy:
+        return "Easy";
+    case Medium:
+        return "Medium";
+    case Hard:
+    default:
+        return "Hard";
+    }
+}
+
+int PuzzleGenerator::minimumMoves(int boardSize, const std::vector<std::pair<int, int>> &queens,
+                                  quint64 nodeBudget, int knownOverlap) {
+    if (boardSize < 1 || boardSize > MAX_BITBOARD_SIZE) {
+        return -1;
+    }
+
+    OverlapSearch search;
+    search.boardSize = boardSize;
+    search.full = boardSize >= 64 ? ~quint64(0) : (quint64(1) << boardSize) - 1;
+    search.placedInRow.assign(boardSize, 0);
+    search.rowsLeftWithQueens.assign(boardSize + 1, 0);
+    search.best = knownOverlap;
+    search.nodes = 0;
+    search.nodeBudget = nodeBudget;
+
+    for (const auto &queen : queens) {
+        if (queen.first >= 0 && queen.first < boardSize && queen.second >= 0 && queen.second < boardSize) {
+            search.placedInRow[queen.first] |= quint64(1) << queen.second;
+        }
+    }
+    for (int row = boardSize - 1; row >= 0; --row) {
+        search.rowsLeftWithQueens[row] = search.rowsLeftWithQueens[row + 1] + (search.placedInRow[row] ? 1 : 0);
+    }
+
+    if (!search.search(0, 0, 0, 0, 0)) {
+        return -1;
+    }
+    return boardSize - search.best;
+}
+
+Puzzle PuzzleGenerator::makeCandidate(int boardSize, int moves, unsigned int seed) {
+    Puzzle puzzle;
+    SolutionSampler sampler(seed);
+    std::vector<int> target = sampler.sample(boardSize);
+    if (target.empty()) {
+        return puzzle;
+    }
+
+    std::mt19937 rng(seed);
+    std::vector<bool> blocked(boardSize * boardSize, false); // Solution squares and taken squares
+    for (int row = 0; row < boardSize; ++row) {
+        blocked[row * boardSize + target[row]] = true;
+    }
+
+    // Knock `moves` queens off the solution, each onto a random free square
+    std::vector<int> rows(boardSize);
+    std::iota(rows.begin(), rows.end(), 0);
+    std::shuffle(rows.begin(), rows.end(), rng);
+    moves = std::clamp(moves, 0, boardSize);
+
+    for (int i = 0; i < boardSize; ++i) {
+        int row = rows[i];
+        if (i >= moves) {
+            puzzle.queens.push_back({row, target[row]});
+            continue;
+        }
+
+        int square;
+        do {
+            square = std::uniform_int_distribution<int>(0, boardSize * boardSize - 1)(rng);
+        } while (blocked[square]);
+        blocked[square] = true;
+        puzzle.queens.push_back({square / boardSize, square % boardSize});
+    }
+
+    // The target already shares boardSize - moves squares; prove nothing shares more
+    puzzle.minMoves = minimumMoves(boardSize, puzzle.queens, 200000, boardSize - moves);
+    return puzzle;
+}
+
+Puzzle PuzzleGenerator::generate(int boardSize, int moves, int timeBudgetMs) {
+    return generate(boardSize, moves, QDeadlineTimer(timeBudgetMs));
+}
+
+Puzzle PuzzleGenerator::generate(int boardSize, int moves, const QDeadlineTimer &deadline) {
+    Puzzle best;
+
+    std::random_device rd;
+    const int batchSize = TaskScheduler::instance().coreBudget();
+
+    do {
+        QList<unsigned int> seeds;
+        for (int i = 0; i < batchSize; ++i) {
+            seeds.append(rd());
+        }
+
+        // Someone is waiting for the new game
+        QList<Puzzle> batch = TaskScheduler::instance().blockingMapped<Puzzle>(
+            seeds, TaskScheduler::Interactive, [boardSize, moves](unsigned int seed) {
+                return makeCandidate(boardSize, moves, seed);
+            });
+
+        for (const Puzzle &candidate : batch) {
+            if (candidate.minMoves == moves) {
+                return candidate;
+            }
+            if (candidate.minMoves > best.minMoves) {
+                best = candidate;
+            }
+        }
+    } while (!deadline.hasExpired());
+
+    // Nothing proven at all, settle for an easier level: one batch each once the time is up
+    if (best.minMoves < 1 && moves > 1) {
+        return generate(boardSize, moves - 1, deadline);
+    }
+    return best;
+}
@@ -0,0 +1,46 @@
+#ifndef PUZZLEGENERATOR_H
+#define PUZZLEGENERATOR_H
+
+#include <QtGlobal>
+#include <QString>
+#include <QDeadlineTimer>
+#include <utility>
+#include <vector>
+
+// A starting board together with its exact distance to the nearest solution
+struct Puzzle {
+    std::vector<std::pair<int, int>> queens; // (row, col) of every queen
+    int minMoves = -1;                       // Minimum queen moves to reach any solution
+};
+
+// Generates starting boards with a known minimum number of moves to solve.
+//
+// A move picks up one queen and drops it on any empty square, so a board is
+// exactly N - k moves away from solved, where k is the largest number of its
+// queens that already sit on the squares of a single solution. Candidates are
+// made by displacing queens from a random solution, then a branch and bound
+// search over all solutions proves k exactly.
+class PuzzleGenerator {
+
+public:
+    enum Difficulty { Easy, Medium, Hard };
+
+    static int movesFor(int boardSize, Difficulty difficulty);
+    static QString difficultyName(Difficulty difficulty);
+
+    // Candidates are built and rated in parallel batches until one with exactly
+    // `moves` is found or the time budget runs out. In the latter case the hardest
+    // proven candidate is returned, so minMoves is always exact. Blocks: call it from the pool.
+    static Puzzle generate(int boardSize, int moves, int timeBudgetMs = 300);
+
+    // Exact minimum moves for boardSize queens, or -1 if the search needs more than nodeBudget nodes.
+    // knownOverlap is a lower bound on the best overlap (0 if unknown) used to prune the search.
+    static int minimumMoves(int boardSize, const std::vector<std::pair<int, int>> &queens,
+                            quint64 nodeBudget, int knownOverlap = 0);
+
+private:
+    static Puzzle makeCandidate(int boardSize, int moves, unsigned int seed);
+    static Puzzle generate(int boardSize, int moves, const QDeadlineTimer &deadline); // Easier levels share the deadline
+};
+
+#endif // PUZZLEGENERATOR_H
@@ -5,8 +5,8 @@
 #include <QCursor>
 
 Queen::Queen(QGraphicsItem *parent)
-    : QGraphicsPixmapItem(parent), m_row(0), m_col(0), beingDragged(false) {
-    setPixmap(QPixmap(":/resources/queen.png").scaled(SQUARE_SIZE, SQUARE_SIZE));
+    : QGraphicsPixmapItem(parent), m_row(0), m_col(0), beingDragged(false), dragRow(0), dragCol(0) {
+    setPixmap(queenPixmap());
     setFlag(QGraphicsItem::ItemIsMovable);
     setFlag(QGraphicsItem::ItemSendsScenePositionChanges);
 }
@@ -27,35 +27,65 @@ int Queen::col() const {
 
 void Queen::mousePressEvent(QGraphicsSceneMouseEvent *event) {
     beingDragged = true;
+    dragRow = m_row;
+    dragCol = m_col;
     setCursor(QCursor(Qt::ClosedHandCursor));
     QGraphicsPixmapItem::mousePressEvent(event);
     
 }
 
-void Queen::mouseReleaseEvent(QGraphicsSceneMouseEvent *event) {
-    beingDragged = false;
-    setCursor(QCursor(Qt::ArrowCursor));
+void Queen::mouseMoveEvent(QGraphicsSceneMouseEvent *event) {
+    QGraphicsPixmapItem::mouseMoveEvent(event);
+
+    // Let the board follow the drag square by square (live attack heatmap)
+    int newRow, newCol;
+    nearestSquare(newRow, newCol);
+    if (beingDragged && (newRow != dragRow || newCol != dragCol)) {
+        auto board = dynamic_cast<ChessBoard *>(scene()->parent());
+        if (board) {
+            board->onQueenDragged(dragRow, dragCol, newRow, newCol);
+        }
+        dragRow = newRow;
+        dragCol = newCol;
+    }
+}
 
-    // Snap the queen to the nearest square
+void Queen::nearestSquare(int &row, int &col) const {
     int x = static_cast<int>(pos().x());
     int y = static_cast<int>(pos().y());
 
-    // Calculate the board size dynamically based on SQUARE_SIZE
-    int boardSize = 800 / SQUARE_SIZE;
+    // Clamped to the board's own squares: 800 / SQUARE_SIZE is more than boardSize on most sizes
+    auto board = scene() ? dynamic_cast<ChessBoard *>(scene()->parent()) : nullptr;
+    int boardSize = board ? board->getBoardSize() : 800 / SQUARE_SIZE;
 
     // Round to the nearest square, based on the grid size
-    int newRow = std::round(y / static_cast<float>(SQUARE_SIZE));
-    int newCol = std::round(x / static_cast<float>(SQUARE_SIZE));
+    row = std::round(y / static_cast<float>(SQUARE_SIZE));
+    col = std::round(x / static_cast<float>(SQUARE_SIZE));
 
-    // Ensure the newRow and newCol are within the bounds of the board (based on boardSize)
-    newRow = std::clamp(newRow, 0, boardSize - 1);  // Dynamic board size
-    newCol = std::clamp(newCol, 0, boardSize - 1);  // Dynamic board size
+    // Ensure the row and col are within the bounds of the board (based on boardSize)
+    row = std::clamp(row, 0, boardSize - 1);  // Dynamic board size
+    col = std::clamp(col, 0, boardSize - 1);  // Dynamic board size
+}
+
+void Queen::mouseReleaseEvent(QGraphicsSceneMouseEvent *event) {
+    beingDragged = false;
+    setCursor(QCursor(Qt::ArrowCursor));
+
+    // Snap the queen to the nearest square
+    int newRow, newCol;
+    nearestSquare(newRow, newCol);
 
+    int oldRow = m_row;
+    int oldCol = m_col;
     setPosition(newRow, newCol);  // Update the position of the queen
 
     // Notify ChessBoard to recheck conflicts
     auto board = dynamic_cast<ChessBoard *>(scene()->parent());
     if (board) {
+        if (newRow != dragRow || newCol != dragCol) {
+            board->onQueenDragged(dragRow, dragCol, newRow, newCol); // Dropped before a move event reached this square
+        }
+        board->onQueenMoved(oldRow, oldCol, newRow, newCol);
         board->checkConflicts();  // Check for conflicts after the move
     }
 
@@ -20,6 +20,7 @@ public:
 protected:
     // Events for dragging the queen
     void mousePressEvent(QGraphicsSceneMouseEvent *event) override;
+    void mouseMoveEvent(QGraphicsSceneMouseEvent *event) override;
     void mouseReleaseEvent(QGraphicsSceneMouseEvent *event) override;
 
 private:
@@ -27,6 +28,10 @@ private:
     int m_col;
 
     bool beingDragged; // State to track dragging
+    int dragRow;       // Square under the queen while dragging
+    int dragCol;
+
+    void nearestSquare(int &row, int &col) const; // Square the queen would snap to
 };
 
 #endif // QUEEN_H
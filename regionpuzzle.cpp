@@ -0,0 +1,427 @@
+#include "regionpuzzle.h"
+
+#include <QtAlgorithms>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+struct RegionState {
+    std::vector<quint64> freeInRow; // Squares a queen may still use, per row
+    quint64 openRows;
+    quint64 openCols;
+    quint64 openRegions;
+    std::vector<int> cols;
+};
+
+struct PropagationSolver {
+    int boardSize;
+    quint64 full;
+    std::vector<int> regions;
+    std::vector<quint64> regionRows; // region * N + row: squares of the region on that row
+    int limit;
+    int found;
+    std::vector<std::vector<int>> *solutions;
+
+    PropagationSolver(int boardSize, const std::vector<int> &regions, int limit,
+                      std::vector<std::vector<int>> *solutions)
+        : boardSize(boardSize), full(boardSize >= 64 ? ~quint64(0) : (quint64(1) << boardSize) - 1),
+          regions(regions), regionRows(boardSize * boardSize, 0), limit(limit), found(0), solutions(solutions) {
+        for (int square = 0; square < boardSize * boardSize; ++square) {
+            regionRows[regions[square] * boardSize + square / boardSize] |= quint64(1) << (square % boardSize);
+        }
+    }
+
+    static quint64 bit(int index) {
+        return quint64(1) << index;
+    }
+
+    void place(RegionState &state, int row, int col) const {
+        const int region = regions[row * boardSize + col];
+        const quint64 colBit = bit(col);
+        const quint64 touching = (colBit | (colBit << 1) | (colBit >> 1)) & full;
+
+        state.cols[row] = col;
+        state.openRows &= ~bit(row);
+        state.openCols &= ~colBit;
+        state.openRegions &= ~bit(region);
+        state.freeInRow[row] = 0;
+        for (int other = 0; other < boardSize; ++other) {
+            state.freeInRow[other] &= ~(colBit | regionRows[region * boardSize + other]);
+        }
+        if (row > 0) {
+            state.freeInRow[row - 1] &= ~touching;
+        }
+        if (row + 1 < boardSize) {
+            state.freeInRow[row + 1] &= ~touching;
+        }
+    }
+
+    int freeInRegion(const RegionState &state, int region) const {
+        int count = 0;
+        for (quint64 rows = state.openRows; rows; rows &= rows - 1) {
+            int row = qCountTrailingZeroBits(rows);
+            count += qPopulationCount(state.freeInRow[row] & regionRows[region * boardSize + row]);
+        }
+        return count;
+    }
+
+    // Removes squares from a row, true if any were still free
+    static bool clear(RegionState &state, int row, quint64 squares) {
+        if (!(state.freeInRow[row] & squares)) {
+            return false;
+        }
+        state.freeInRow[row] &= ~squares;
+        return true;
+    }
+
+    // Fills in forced queens and removes squares no solution can use, until nothing changes.
+    // False if some row, column or region can no longer get its queen.
+    bool propagate(RegionState &state) const {
+        bool changed = true;
+        while (changed) {
+            changed = false;
+
+            // Rows: a single free square is forced, free squares all in one region claim that region
+            for (quint64 rows = state.openRows; rows; rows &= rows - 1) {
+                int row = qCountTrailingZeroBits(rows);
+                quint64 squares = state.freeInRow[row];
+                if (!squares) {
+                    return false;
+                }
+                if (!(squares & (squares - 1))) {
+                    place(state, row, qCountTrailingZeroBits(squares));
+                    changed = true;
+                    continue;
+                }
+                int region = regions[row * boardSize + qCountTrailingZeroBits(squares)];
+                if ((squares & regionRows[region * boardSize + row]) == squares) {
+                    for (quint64 others = state.openRows & ~bit(row); others; others &= others - 1) {
+                        int other = qCountTrailingZeroBits(others);
+                        changed |= clear(state, other, regionRows[region * boardSize + other]);
+                    }
+                }
+            }
+
+            // Regions: same, and a region confined to one row or column claims it
+            for (quint64 open = state.openRegions; open; open &= open - 1) {
+                int region = qCountTrailingZeroBits(open);
+                if (!(state.openRegions & bit(region))) {
+                    continue; // Filled in by a forced queen above
+                }
+
+                quint64 rowsUsed = 0;
+                quint64 colsUsed = 0;
+                int count = 0;
+                for (quint64 rows = state.openRows; rows; rows &= rows - 1) {
+                    int row = qCountTrailingZeroBits(rows);
+                    quint64 squares = state.freeInRow[row] & regionRows[region * boardSize + row];
+                    if (squares) {
+                        rowsUsed |= bit(row);
+                        colsUsed |= squares;
+                        count += qPopulationCount(squares);
+                    }
+                }
+
+                if (count == 0) {
+                    return false;
+                }
+                if (count == 1) {
+                    place(state, qCountTrailingZeroBits(rowsUsed), qCountTrailingZeroBits(colsUsed));
+                    changed = true;
+                    continue;
+                }
+                if (!(rowsUsed & (rowsUsed - 1))) {
+                    int row = qCountTrailingZeroBits(rowsUsed);
+                    changed |= clear(state, row, ~regionRows[region * boardSize + row]);
+                }
+                if (!(colsUsed & (colsUsed - 1))) {
+                    for (quint64 rows = state.openRows; rows; rows &= rows - 1) {
+                        int row = qCountTrailingZeroBits(rows);
+                        changed |= clear(state, row, colsUsed & ~regionRows[region * boardSize + row]);
+                    }
+                }
+            }
+
+            // Columns: every open one needs a free square, all of them in one region claim it
+            quint64 reachable = 0;
+            for (quint64 rows = state.openRows; rows; rows &= rows - 1) {
+                reachable |= state.freeInRow[qCountTrailingZeroBits(rows)];
+            }
+            if ((reachable & state.openCols) != state.openCols) {
+                return false;
+            }
+            for (quint64 open = state.openCols; open && !changed; open &= open - 1) {
+                int col = qCountTrailingZeroBits(open);
+                int region = -1;
+                bool oneRegion = true;
+                for (quint64 rows = state.openRows; rows && oneRegion; rows &= rows - 1) {
+                    int row = qCountTrailingZeroBits(rows);
+                    if (state.freeInRow[row] & bit(col)) {
+                        int squareRegion = regions[row * boardSize + col];
+                        oneRegion = region < 0 || region == squareRegion;
+                        region = squareRegion;
+                    }
+                }
+                if (oneRegion) {
+                    for (quint64 rows = state.openRows; rows; rows &= rows - 1) {
+                        int row = qCountTrailingZeroBits(rows);
+                        changed |= clear(state, row, regionRows[region * boardSize + row] & ~bit(col));
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    void search(RegionState &state) {
+        if (found >= limit || !propagate(state)) {
+            return;
+        }
+        if (!state.openRows) {
+            ++found;
+            if (solutions) {
+                solutions->push_back(state.cols);
+            }
+            return;
+        }
+
+        // Branch on the row or region with the fewest free squares
+        int bestRow = -1;
+        int bestCount = boardSize + 1;
+        for (quint64 rows = state.openRows; rows; rows &= rows - 1) {
+            int row = qCountTrailingZeroBits(rows);
+            int count = qPopulationCount(state.freeInRow[row]);
+            if (count < bestCount) {
+                bestCount = count;
+                bestRow = row;
+            }
+        }
+        int bestRegion = -1;
+        for (quint64 open = state.openRegions; open; open &= open - 1) {
+            int region = qCountTrailingZeroBits(open);
+            int count = freeInRegion(state, region);
+            if (count < bestCount) {
+                bestCount = count;
+                bestRegion = region;
+            }
+        }
+
+        for (quint64 rows = bestRegion >= 0 ? state.openRows : bit(bestRow); rows && found < limit; rows &= rows - 1) {
+            int row = qCountTrailingZeroBits(rows);
+            quint64 squares = state.freeInRow[row];
+            if (bestRegion >= 0) {
+                squares &= regionRows[bestRegion * boardSize + row];
+            }
+            for (; squares && found < limit; squares &= squares - 1) {
+                RegionState next = state;
+                place(next, row, qCountTrailingZeroBits(squares));
+                search(next);
+            }
+        }
+    }
+};
+
+bool validLayout(int boardSize, const std::vector<int> &regions) {
+    if (boardSize < 1 || boardSize > 64 || int(regions.size()) != boardSize * boardSize) {
+        return false;
+    }
+    return std::all_of(regions.begin(), regions.end(), [boardSize](int region) {
+        return region >= 0 && region < boardSize;
+    });
+}
+
+// Random solution of the row, column and no-touching rules, regions come later
+bool randomQueens(int boardSize, int row, std::vector<int> &cols, quint64 usedCols, std::mt19937 &rng) {
+    if (row == boardSize) {
+        return true;
+    }
+    std::vector<int> order(boardSize);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), rng);
+    for (int col : order) {
+        if ((usedCols >> col) & 1 || (row > 0 && std::abs(cols[row - 1] - col) <= 1)) {
+            continue;
+        }
+        cols[row] = col;
+        if (randomQueens(boardSize, row + 1, cols, usedCols | (quint64(1) << col), rng)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const int STEPS[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+
+// Region k starts on the queen of row k and takes random free neighbours until the board is full
+std::vector<int> growRegions(int boardSize, const std::vector<int> &cols, std::mt19937 &rng) {
+    std::vector<int> regions(boardSize * boardSize, -1);
+    std::vector<std::pair<int, int>> edges; // (from square, to square)
+    auto addEdges = [&](int square) {
+        int row = square / boardSize;
+        int col = square % boardSize;
+        for (const auto &step : STEPS) {
+            int r = row + step[0];
+            int c = col + step[1];
+            if (r >= 0 && r < boardSize && c >= 0 && c < boardSize) {
+                edges.push_back({square, r * boardSize + c});
+            }
+        }
+    };
+
+    for (int row = 0; row < boardSize; ++row) {
+        regions[row * boardSize + cols[row]] = row;
+        addEdges(row * boardSize + cols[row]);
+    }
+    while (!edges.empty()) {
+        std::uniform_int_distribution<size_t> pick(0, edges.size() - 1);
+        size_t index = pick(rng);
+        std::pair<int, int> edge = edges[index];
+        edges[index] = edges.back();
+        edges.pop_back();
+        if (regions[edge.second] < 0) {
+            regions[edge.second] = regions[edge.first];
+            addEdges(edge.second);
+        }
+    }
+    return regions;
+}
+
+// Whether the region of `square` stays in one piece without it
+bool staysConnected(int boardSize, const std::vector<int> &regions, int square) {
+    const int region = regions[square];
+    std::vector<int> stack;
+    std::vector<bool> seen(regions.size(), false);
+    int size = 0;
+    for (int other = 0; other < int(regions.size()); ++other) {
+        if (other != square && regions[other] == region) {
+            ++size;
+            if (stack.empty()) {
+                stack.push_back(other);
+                seen[other] = true;
+            }
+        }
+    }
+
+    int reached = 0;
+    while (!stack.empty()) {
+        int current = stack.back();
+        stack.pop_back();
+        ++reached;
+        for (const auto &step : STEPS) {
+            int r = current / boardSize + step[0];
+            int c = current % boardSize + step[1];
+            int next = r * boardSize + c;
+            if (r >= 0 && r < boardSize && c >= 0 && c < boardSize && next != square &&
+                !seen[next] && regions[next] == region) {
+                seen[next] = true;
+                stack.push_back(next);
+            }
+        }
+    }
+    return reached == size;
+}
+
+// Whether every region still holds exactly one queen of the solution
+bool stillSolves(int boardSize, const std::vector<int> &regions, const std::vector<int> &cols) {
+    quint64 used = 0;
+    for (int row = 0; row < boardSize; ++row) {
+        used |= quint64(1) << regions[row * boardSize + cols[row]];
+    }
+    return qPopulationCount(used) == boardSize;
+}
+
+// Hands one square of `other` that `cols` doesn't use to a neighbouring region
+bool breakSolution(int boardSize, std::vector<int> &regions, const std::vector<int> &cols,
+                   const std::vector<int> &other, std::mt19937 &rng) {
+    std::vector<int> squares;
+    for (int row = 0; row < boardSize; ++row) {
+        if (other[row] != cols[row]) {
+            squares.push_back(row * boardSize + other[row]);
+        }
+    }
+    std::shuffle(squares.begin(), squares.end(), rng);
+
+    for (int square : squares) {
+        if (!staysConnected(boardSize, regions, square)) {
+            continue;
+        }
+        for (const auto &step : STEPS) {
+            int r = square / boardSize + step[0];
+            int c = square % boardSize + step[1];
+            if (r >= 0 && r < boardSize && c >= 0 && c < boardSize && regions[r * boardSize + c] != regions[square]) {
+                regions[square] = regions[r * boardSize + c];
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+int RegionPuzzle::countSolutions(int boardSize, const std::vector<int> &regions, int limit,
+                                 std::vector<std::vector<int>> *solutions) {
+    if (!validLayout(boardSize, regions) || limit < 1) {
+        return 0;
+    }
+
+    PropagationSolver solver(boardSize, regions, limit, solutions);
+    RegionState state{std::vector<quint64>(boardSize, solver.full), solver.full, solver.full, solver.full,
+                      std::vector<int>(boardSize, -1)};
+    solver.search(state);
+    return solver.found;
+}
+
+std::vector<int> RegionPuzzle::solve(int boardSize, const std::vector<int> &regions) {
+    std::vector<std::vector<int>> solutions;
+    countSolutions(boardSize, regions, 1, &solutions);
+    return solutions.empty() ? std::vector<int>() : solutions.front();
+}
+
+RegionLayout RegionPuzzle::generate(int boardSize, int timeBudgetMs, unsigned int seed) {
+    RegionLayout layout;
+    std::mt19937 rng(seed);
+    std::vector<int> cols(boardSize, -1);
+    if (boardSize < 1 || boardSize > 64 || !randomQueens(boardSize, 0, cols, 0, rng)) {
+        return layout; // 2 and 3 have no solution at all
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    do {
+        layout.solution = cols;
+        layout.regions = growRegions(boardSize, cols, rng);
+
+        // Our queens keep their regions, so they stay a solution. A square of another
+        // solution handed to a neighbouring region puts two of its queens in one region.
+        // Each round breaks a batch of other solutions before counting again.
+        bool stuck = false;
+        for (int round = 0; !stuck && round < 2 * boardSize && timer.elapsed() < timeBudgetMs; ++round) {
+            std::vector<std::vector<int>> solutions;
+            countSolutions(boardSize, layout.regions, boardSize + 1, &solutions);
+            solutions.erase(std::remove(solutions.begin(), solutions.end(), cols), solutions.end());
+            if (solutions.empty()) {
+                layout.unique = true;
+                return layout;
+            }
+
+            bool progress = false;
+            for (const std::vector<int> &other : solutions) {
+                // Skip the ones a move of this round already broke
+                if (!stillSolves(boardSize, layout.regions, other) ||
+                    breakSolution(boardSize, layout.regions, cols, other, rng)) {
+                    progress = true;
+                }
+            }
+            stuck = !progress;
+        }
+
+        // Stuck or going in circles, start over from another solution
+        randomQueens(boardSize, 0, cols, 0, rng);
+    } while (timer.elapsed() < timeBudgetMs);
+
+    return layout;
+}
@@ -0,0 +1,41 @@
+#ifndef REGIONPUZZLE_H
+#define REGIONPUZZLE_H
+
+#include <QtGlobal>
+#include <random>
+#include <vector>
+
+// A colored-regions board: region (0..N-1) of every square, row * N + col
+struct RegionLayout {
+    std::vector<int> regions;
+    std::vector<int> solution; // Column of the queen on every row
+    bool unique = false;       // Proven to have no other solution
+};
+
+// Solver and generator for the colored-regions puzzle: one queen per row, per
+// column and per region, and no two queens on touching squares.
+//
+// The solver keeps the free squares of every row as a bitmask. Placing a queen
+// clears its column, its region and its neighbours, then rows or regions left
+// with a single free square are filled in until nothing changes; only then does
+// it branch, on the row or region with the fewest free squares.
+class RegionPuzzle {
+
+public:
+    // Largest board the game offers: bigger layouts take longer than a click should to prove unique
+    static constexpr int MAX_GAME_SIZE = 14;
+
+    // Counts solutions, stopping at `limit` (2 is enough to prove uniqueness).
+    // The solutions found are appended to `solutions` if given.
+    static int countSolutions(int boardSize, const std::vector<int> &regions, int limit,
+                              std::vector<std::vector<int>> *solutions = nullptr);
+
+    // First solution found, or empty if there is none
+    static std::vector<int> solve(int boardSize, const std::vector<int> &regions);
+
+    // Grows regions around the queens of a random solution, then moves squares between
+    // regions until no other solution is left. Gives up on uniqueness after the time budget.
+    static RegionLayout generate(int boardSize, int timeBudgetMs = 500, unsigned int seed = std::random_device()());
+};
+
+#endif // REGIONPUZZLE_H
@@ -0,0 +1,251 @@
+#include "solutionenumerator.h"
+#include "taskscheduler.h"
+
+#include <QSaveFile>
+#include <QMutex>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <algorithm>
+#include <atomic>
+
+SolutionEnumerator::SolutionEnumerator(int boardSize, const QString &checkpointPath, const QString &outputPath,
+                                       const BoardVariant &variant)
+    : boardSize(boardSize), variant(variant), checkpointPath(checkpointPath), outputPath(outputPath),
+      unitCount(0), count(0), resumed(false), finished(false), checkpointInterval(5000) {
+}
+
+SolutionEnumerator::~SolutionEnumerator() {
+    // Keep the frontier if the run was interrupted, so it can be resumed later
+    if (unitCount > 0 && !finished && error.isEmpty()) {
+        saveCheckpoint();
+    }
+}
+
+bool SolutionEnumerator::start() {
+    qint64 outputOffset = 0;
+    resumed = loadCheckpoint(outputOffset);
+
+    if (!resumed) {
+        // Bigger boards get deeper prefixes so each unit stays short
+        std::vector<Prefix> units = splitWorkUnits(boardSize, boardSize >= 14 ? 3 : 2, variant);
+        pendingUnits.assign(units.begin(), units.end());
+        unitCount = int(units.size());
+        count = 0;
+    }
+
+    if (!openOutput(outputOffset)) {
+        unitCount = 0; // Nothing to checkpoint
+        return false;
+    }
+
+    sinceCheckpoint.start();
+    return true;
+}
+
+bool SolutionEnumerator::loadCheckpoint(qint64 &outputOffset) {
+    QFile file(checkpointPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false; // No checkpoint, fresh start
+    }
+
+    QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    if (root.value("boardSize").toInt() != boardSize || root.value("output").toString() != outputPath ||
+        root.value("variant").toString() != variant.describe()) {
+        return false; // Checkpoint belongs to a different run
+    }
+
+    pendingUnits.clear();
+    for (const QJsonValue &unit : root.value("pending").toArray()) {
+        Prefix prefix;
+        for (const QJsonValue &col : unit.toArray()) {
+            prefix.push_back(col.toInt());
+        }
+        pendingUnits.push_back(prefix);
+    }
+
+    unitCount = root.value("totalUnits").toInt();
+    count = root.value("count").toString().toULongLong();
+    outputOffset = root.value("outputOffset").toString().toLongLong();
+    return true;
+}
+
+bool SolutionEnumerator::openOutput(qint64 offset) {
+    if (outputPath.isEmpty()) {
+        return true; // Counting only
+    }
+
+    output.setFileName(outputPath);
+    if (!output.open(QIODevice::ReadWrite)) {
+        error = output.errorString();
+        return false;
+    }
+
+    if (output.size() < offset) {
+        error = QString("%1 is shorter than its checkpoint; delete %2 to start over.").arg(outputPath, checkpointPath);
+        output.close();
+        return false;
+    }
+
+    // Drop whatever the interrupted run wrote after its last checkpoint
+    output.resize(offset);
+    output.seek(offset);
+    return true;
+}
+
+bool SolutionEnumerator::processNextUnits() {
+    if (finished || !error.isEmpty()) {
+        return false;
+    }
+
+    if (pendingUnits.empty()) {
+        finish();
+        return false;
+    }
+
+    // Background priority: interactive work takes over the threads between two units
+    const int batchSize = std::min(int(pendingUnits.size()), TaskScheduler::instance().coreBudget());
+    std::vector<quint64> counts(batchSize, 0);
+    const bool writing = output.isOpen();
+
+    // Solutions are written in unit order, so the output matches a serial run. The oldest unfinished
+    // unit streams its lines to the file in chunks, later ones buffer until every unit before them is done.
+    const int chunkSize = 64 * 1024;
+    std::vector<QByteArray> lines(batchSize);
+    std::vector<bool> unitDone(batchSize, false);
+    std::atomic<int> nextToWrite{0}; // Advanced under outputMutex
+    bool writeFailed = false;
+    QMutex outputMutex;
+
+    auto writeOut = [&](QByteArray &bytes) { // Caller holds outputMutex
+        if (!writeFailed && output.write(bytes) != bytes.size()) {
+            writeFailed = true;
+        }
+        bytes = QByteArray();
+    };
+
+    TaskScheduler::instance().blockingFor(batchSize, TaskScheduler::Background, [&](int index) {
+        SolutionVisitor visitor;
+        if (writing) {
+            visitor = [&, index](const std::vector<int> &cols) {
+                QByteArray &buffer = lines[index];
+                for (size_t row = 0; row < cols.size(); ++row) {
+                    if (row > 0) {
+                        buffer += ' ';
+                    }
+                    buffer += QByteArray::number(cols[row]);
+                }
+                buffer += '\n';
+                if (buffer.size() >= chunkSize && nextToWrite == index) {
+                    QMutexLocker locker(&outputMutex);
+                    writeOut(buffer);
+                }
+                return true;
+            };
+        }
+        counts[index] = searchFromPrefix(boardSize, pendingUnits[index], visitor, variant);
+
+        if (writing) {
+            QMutexLocker locker(&outputMutex);
+            unitDone[index] = true;
+            while (nextToWrite < batchSize && unitDone[nextToWrite]) {
+                writeOut(lines[nextToWrite]);
+                ++nextToWrite;
+            }
+            if (!writeFailed && !output.flush()) {
+                writeFailed = true;
+            }
+        }
+    });
+
+    if (writeFailed) {
+        error = output.errorString();
+        return false;
+    }
+    for (int index = 0; index < batchSize; ++index) {
+        count += counts[index];
+        pendingUnits.pop_front();
+    }
+
+    if (sinceCheckpoint.elapsed() >= checkpointInterval) {
+        saveCheckpoint();
+    }
+    return true;
+}
+
+bool SolutionEnumerator::saveCheckpoint() {
+    // Solutions must be on disk before the checkpoint points past them
+    if (output.isOpen() && !output.flush()) {
+        error = output.errorString();
+        return false;
+    }
+
+    QJsonArray pending;
+    for (const Prefix &unit : pendingUnits) {
+        QJsonArray cols;
+        for (int col : unit) {
+            cols.append(col);
+        }
+        pending.append(cols);
+    }
+
+    QJsonObject root;
+    root["boardSize"] = boardSize;
+    root["variant"] = variant.describe();
+    root["output"] = outputPath;
+    root["totalUnits"] = unitCount;
+    root["count"] = QString::number(count); // Too big for a JSON double on large boards
+    root["outputOffset"] = QString::number(output.isOpen() ? output.pos() : 0);
+    root["pending"] = pending;
+
+    // QSaveFile replaces the old checkpoint atomically, so a crash never leaves half a file
+    QSaveFile file(checkpointPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        error = file.errorString();
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    if (!file.commit()) {
+        error = file.errorString();
+        return false;
+    }
+
+    sinceCheckpoint.restart();
+    return true;
+}
+
+void SolutionEnumerator::finish() {
+    finished = true;
+    if (output.isOpen()) {
+        output.close();
+    }
+    QFile::remove(checkpointPath);
+}
+
+void SolutionEnumerator::setCheckpointInterval(int msec) {
+    checkpointInterval = msec;
+}
+
+bool SolutionEnumerator::isFinished() const {
+    return finished;
+}
+
+bool SolutionEnumerator::wasResumed() const {
+    return resumed;
+}
+
+int SolutionEnumerator::totalUnits() const {
+    return unitCount;
+}
+
+int SolutionEnumerator::remainingUnits() const {
+    return int(pendingUnits.size());
+}
+
+quint64 SolutionEnumerator::solutionCount() const {
+    return count;
+}
+
+QString SolutionEnumerator::errorString() const {
+    return error;
+}
@@ -0,0 +1,57 @@
+#ifndef SOLUTIONENUMERATOR_H
+#define SOLUTIONENUMERATOR_H
+
+#include <QString>
+#include <QFile>
+#include <QElapsedTimer>
+#include <deque>
+#include "bitboard.h"
+
+// Counts (and optionally writes out) every solution of an N-Queens board.
+// The search is split into prefix work units so a long run can periodically
+// save its frontier to a checkpoint file and resume after a crash or restart.
+class SolutionEnumerator {
+
+public:
+    // outputPath may be empty to only count solutions
+    SolutionEnumerator(int boardSize, const QString &checkpointPath, const QString &outputPath = QString(),
+                       const BoardVariant &variant = BoardVariant());
+    ~SolutionEnumerator();
+
+    bool start();            // Resume from the checkpoint if there is one, otherwise start from row 0
+    bool processNextUnits(); // One unit per thread of the core budget, false once finished or on error.
+                             // Blocks until the batch is done, so callers with a UI run it on the pool
+    bool saveCheckpoint();   // Also called automatically every checkpointInterval ms
+
+    void setCheckpointInterval(int msec);
+
+    bool isFinished() const;
+    bool wasResumed() const;
+    int totalUnits() const;
+    int remainingUnits() const;
+    quint64 solutionCount() const;
+    QString errorString() const;
+
+private:
+    int boardSize;
+    BoardVariant variant;
+    QString checkpointPath;
+    QString outputPath;
+    QFile output;
+
+    std::deque<Prefix> pendingUnits; // Work units not yet searched
+    int unitCount;
+    quint64 count;
+    bool resumed;
+    bool finished;
+    QString error;
+
+    QElapsedTimer sinceCheckpoint;
+    int checkpointInterval;
+
+    bool loadCheckpoint(qint64 &outputOffset);
+    bool openOutput(qint64 offset);
+    void finish();
+};
+
+#endif // SOLUTIONENUMERATOR_H
@@ -0,0 +1,116 @@
+#include "solutionsampler.h"
+#include "bitboard.h"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <numeric>
+
+SolutionSampler::SolutionSampler(unsigned int seed) : rng(seed) {
+}
+
+std::vector<int> SolutionSampler::sample(int boardSize) {
+    if (boardSize < 1) {
+        return {};
+    }
+    if (boardSize <= MAX_INDEXED_SIZE) {
+        return sampleFromIndex(boardSize);
+    }
+    return sampleMinConflicts(boardSize);
+}
+
+const std::vector<int> &SolutionSampler::solutionIndex(int boardSize) {
+    static std::mutex mutex;
+    static std::map<int, std::vector<int>> indexes;
+
+    // Built once per size, shared by every sampler (and thread)
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = indexes.find(boardSize);
+    if (it == indexes.end()) {
+        std::vector<int> &index = indexes[boardSize];
+        searchFromPrefix(boardSize, Prefix(), [&index](const std::vector<int> &cols) {
+            index.insert(index.end(), cols.begin(), cols.end());
+            return true;
+        });
+        return index;
+    }
+    return it->second;
+}
+
+std::vector<int> SolutionSampler::sampleFromIndex(int boardSize) {
+    const std::vector<int> &index = solutionIndex(boardSize);
+    const size_t solutions = index.size() / boardSize;
+    if (solutions == 0) {
+        return {};
+    }
+
+    size_t pick = std::uniform_int_distribution<size_t>(0, solutions - 1)(rng);
+    auto first = index.begin() + pick * boardSize;
+    return std::vector<int>(first, first + boardSize);
+}
+
+std::vector<int> SolutionSampler::sampleMinConflicts(int boardSize) {
+    const int maxRestarts = 50;
+    const int maxSteps = 100 * boardSize;
+
+    std::vector<int> cols(boardSize);
+    std::vector<int> colCount(boardSize);
+    std::vector<int> diag1(2 * boardSize - 1); // row + col
+    std::vector<int> diag2(2 * boardSize - 1); // row - col + boardSize - 1
+    std::vector<int> conflicted;
+    std::vector<int> bestCols;
+
+    auto attacks = [&](int row, int col) {
+        return colCount[col] + diag1[row + col] + diag2[row - col + boardSize - 1];
+    };
+    auto place = [&](int row, int col, int delta) {
+        colCount[col] += delta;
+        diag1[row + col] += delta;
+        diag2[row - col + boardSize - 1] += delta;
+    };
+
+    for (int restart = 0; restart < maxRestarts; ++restart) {
+        // Start from a random permutation so columns are already conflict free
+        std::iota(cols.begin(), cols.end(), 0);
+        std::shuffle(cols.begin(), cols.end(), rng);
+        std::fill(colCount.begin(), colCount.end(), 0);
+        std::fill(diag1.begin(), diag1.end(), 0);
+        std::fill(diag2.begin(), diag2.end(), 0);
+        for (int row = 0; row < boardSize; ++row) {
+            place(row, cols[row], 1);
+        }
+
+        for (int step = 0; step < maxSteps; ++step) {
+            conflicted.clear();
+            for (int row = 0; row < boardSize; ++row) {
+                if (attacks(row, cols[row]) > 3) { // 3 = the queen counting itself on each line
+                    conflicted.push_back(row);
+                }
+            }
+            if (conflicted.empty()) {
+                return cols;
+            }
+
+            // Move a random conflicted queen to the least attacked column of its row, ties broken randomly
+            int row = conflicted[std::uniform_int_distribution<size_t>(0, conflicted.size() - 1)(rng)];
+            place(row, cols[row], -1);
+
+            int minAttacks = boardSize * 3;
+            bestCols.clear();
+            for (int col = 0; col < boardSize; ++col) {
+                int count = attacks(row, col);
+                if (count < minAttacks) {
+                    minAttacks = count;
+                    bestCols.clear();
+                }
+                if (count == minAttacks) {
+                    bestCols.push_back(col);
+                }
+            }
+
+            cols[row] = bestCols[std::uniform_int_distribution<size_t>(0, bestCols.size() - 1)(rng)];
+            place(row, cols[row], 1);
+        }
+    }
+    return {}; // Gave up; callers fall back to a deterministic solver
+}
@@ -0,0 +1,30 @@
+#ifndef SOLUTIONSAMPLER_H
+#define SOLUTIONSAMPLER_H
+
+#include <random>
+#include <vector>
+
+// Draws random N-Queens solutions.
+// Small boards are drawn uniformly from a cached index of every solution,
+// bigger boards use min-conflicts with random restarts (near-uniform, fast for any N).
+class SolutionSampler {
+
+public:
+    explicit SolutionSampler(unsigned int seed = std::random_device()());
+
+    // Column of the queen on each row, or empty if the board has no solution
+    std::vector<int> sample(int boardSize);
+
+    // Boards up to this size are sampled exactly uniformly
+    static constexpr int MAX_INDEXED_SIZE = 12;
+
+private:
+    std::mt19937 rng;
+
+    std::vector<int> sampleFromIndex(int boardSize);
+    std::vector<int> sampleMinConflicts(int boardSize);
+
+    static const std::vector<int> &solutionIndex(int boardSize); // Row-major, boardSize ints per solution
+};
+
+#endif // SOLUTIONSAMPLER_H
@@ -0,0 +1,492 @@
+#include "solverselector.h"
+#include "bitboard.h"
+#include "regionpuzzle.h"
+#include "solutionsampler.h"
+
+#include <QDeadlineTimer>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <numeric>
+#include <random>
+
+namespace {
+
+constexpr int PROFILE_VERSION = 1;
+
+// An engine gets this many times its predicted cost before the next one takes over
+constexpr double BUDGET_FACTOR = 4.0;
+constexpr qint64 MIN_BUDGET_MS = 20;
+
+// Once every engine ran over, the first exhaustive one gets this long before the solve gives up
+constexpr qint64 FALLBACK_BUDGET_MS = 10000;
+
+// The other engines always give the same solution for a board, so on classic boards the random
+// sampler goes first while it is predicted to fit in this; Constructive backs it up when it gives up
+constexpr double SAMPLER_FIRST_MS = MIN_BUDGET_MS;
+
+// Calibration: boards measured, and the time after which a run counts as too slow
+constexpr int CALIBRATION_MIN_SIZE = 4;
+constexpr int CALIBRATION_MAX_SIZE = 32;
+constexpr int CALIBRATION_REGION_SIZES[] = {6, 8, 10, 12};
+constexpr qint64 CALIBRATION_BUDGET_MS = 250;
+
+// Engine names in the profile file, in Engine order
+const char *const PROFILE_KEYS[] = {"constructive", "sampler", "bitboard", "backtracking", "regions"};
+const char *const FAMILY_KEYS[] = {"plain", "regions"};
+
+bool isExhaustive(SolverSelector::Engine engine) {
+    // These prove there is no solution when they come back empty in time
+    return engine == SolverSelector::Bitboard || engine == SolverSelector::Backtracking ||
+           engine == SolverSelector::RegionPropagation;
+}
+
+// Explicit solution for every N but 2 and 3: even columns then odd ones,
+// with the known fix-ups when N % 6 is 2 or 3. On a torus, when N is prime to 6,
+// the knight step (2r mod N) works. A random symmetry of the board keeps repeated
+// solves from always showing the same placement.
+std::vector<int> construct(int boardSize, bool toroidal, std::mt19937 &rng) {
+    std::vector<int> cols;
+    if (toroidal) {
+        if (std::gcd(boardSize, 6) != 1) {
+            return cols;
+        }
+        for (int row = 0; row < boardSize; ++row) {
+            cols.push_back(2 * row % boardSize);
+        }
+    } else {
+        if (boardSize == 2 || boardSize == 3) {
+            return cols;
+        }
+        std::vector<int> evens; // 1-based columns, as in the usual statement of the rule
+        std::vector<int> odds;
+        for (int col = 2; col <= boardSize; col += 2) {
+            evens.push_back(col);
+        }
+        for (int col = 1; col <= boardSize; col += 2) {
+            odds.push_back(col);
+        }
+        if (boardSize % 6 == 2) {
+            std::swap(odds[0], odds[1]);                        // 3, 1, 5, 7, ...
+            odds.erase(odds.begin() + 2);
+            odds.push_back(5);                                  // 3, 1, 7, 9, ..., 5
+        } else if (boardSize % 6 == 3) {
+            evens.erase(evens.begin());
+            evens.push_back(2);                                 // 4, 6, ..., 2
+            odds.erase(odds.begin(), odds.begin() + 2);
+            odds.push_back(1);
+            odds.push_back(3);                                  // 5, 7, ..., 1, 3
+        }
+        for (int col : evens) {
+            cols.push_back(col - 1);
+        }
+        for (int col : odds) {
+            cols.push_back(col - 1);
+        }
+    }
+
+    const int symmetry = std::uniform_int_distribution<int>(0, 7)(rng);
+    if (symmetry & 1) {
+        for (int &col : cols) {
+            col = boardSize - 1 - col; // Mirror left to right
+        }
+    }
+    if (symmetry & 2) {
+        std::reverse(cols.begin(), cols.end()); // Mirror top to bottom
+    }
+    if (symmetry & 4) {
+        std::vector<int> transposed(boardSize);
+        for (int row = 0; row < boardSize; ++row) {
+            transposed[cols[row]] = row;
+        }
+        cols.swap(transposed);
+    }
+    return cols;
+}
+
+// Row by row with an array of columns, checking every queen above; slow but has no size limit
+struct Backtracker {
+    int boardSize;
+    const BoardVariant &variant;
+    const QDeadlineTimer &deadline;
+    std::vector<int> cols;
+    quint64 nodes = 0;
+    bool timedOut = false;
+
+    bool isSafe(int row, int col) const {
+        if (variant.isBlocked(row, col) || (variant.fixedCol(row) >= 0 && variant.fixedCol(row) != col)) {
+            return false;
+        }
+        for (int i = 0; i < row; ++i) {
+            if (variant.attacks(boardSize, i, cols[i], row, col)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool search(int row) {
+        if (row == boardSize) {
+            return true;
+        }
+        if ((++nodes & 0x3ff) == 0 && deadline.hasExpired()) {
+            timedOut = true;
+            return false;
+        }
+        for (int col = 0; col < boardSize && !timedOut; ++col) {
+            if (isSafe(row, col)) {
+                cols[row] = col;
+                if (search(row + 1)) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+};
+
+std::vector<int> runEngine(SolverSelector::Engine engine, int boardSize, const BoardVariant &variant,
+                           const QDeadlineTimer &deadline, bool &timedOut) {
+    thread_local std::mt19937 rng(std::random_device{}());
+    thread_local SolutionSampler sampler;
+    timedOut = false;
+
+    switch (engine) {
+    case SolverSelector::Constructive:
+        return construct(boardSize, variant.toroidal, rng);
+    case SolverSelector::Sampler:
+        return sampler.sample(boardSize); // Bounded restarts, no deadline needed
+    case SolverSelector::Bitboard:
+        return findFirstSolution(boardSize, variant, deadline, &timedOut);
+    case SolverSelector::Backtracking: {
+        Backtracker backtracker{boardSize, variant, deadline, std::vector<int>(boardSize, -1)};
+        bool found = backtracker.search(0);
+        timedOut = backtracker.timedOut;
+        return found ? backtracker.cols : std::vector<int>();
+    }
+    case SolverSelector::RegionPropagation:
+        return RegionPuzzle::solve(boardSize, variant.regions); // Propagation keeps it fast
+    default:
+        return {};
+    }
+}
+
+bool isApplicable(SolverSelector::Engine engine, int boardSize, const BoardVariant &variant) {
+    switch (engine) {
+    case SolverSelector::Constructive: {
+        BoardVariant plain = variant;
+        plain.toroidal = false;
+        return plain.isClassic() && (variant.toroidal ? std::gcd(boardSize, 6) == 1
+                                                      : boardSize != 2 && boardSize != 3);
+    }
+    case SolverSelector::Sampler:
+        return variant.isClassic();
+    case SolverSelector::Bitboard:
+        return boardSize <= MAX_BITBOARD_SIZE;
+    case SolverSelector::Backtracking:
+        return true;
+    case SolverSelector::RegionPropagation:
+        return variant.hasRegions();
+    default:
+        return false;
+    }
+}
+
+// Rough costs in ms, used until a calibration run has measured this machine
+double defaultMs(SolverSelector::Engine engine, int boardSize, bool regions) {
+    switch (engine) {
+    case SolverSelector::Constructive:
+        return 0.0002 * boardSize;
+    case SolverSelector::Sampler:
+        return boardSize <= SolutionSampler::MAX_INDEXED_SIZE ? 0.002 : 0.0003 * boardSize * boardSize;
+    case SolverSelector::Bitboard:
+        return (regions ? 2e-4 * std::pow(1.25, boardSize) : 1e-4 * std::pow(1.35, boardSize));
+    case SolverSelector::Backtracking:
+        return 10 * defaultMs(SolverSelector::Bitboard, boardSize, regions);
+    case SolverSelector::RegionPropagation:
+        return 0.005 * boardSize * boardSize;
+    default:
+        return 1e9;
+    }
+}
+
+// Average ms per run, repeating quick runs so the clock resolution doesn't matter
+double timeEngine(SolverSelector::Engine engine, int boardSize, const BoardVariant &variant, bool &timedOut) {
+    QDeadlineTimer deadline(CALIBRATION_BUDGET_MS);
+    if (engine == SolverSelector::Sampler) {
+        runEngine(engine, boardSize, variant, deadline, timedOut); // Builds the solution index once
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    int runs = 0;
+    do {
+        runEngine(engine, boardSize, variant, deadline, timedOut);
+        ++runs;
+    } while (!timedOut && timer.elapsed() < 5 && runs < 100);
+
+    return timedOut ? double(CALIBRATION_BUDGET_MS) : timer.nsecsElapsed() / 1e6 / runs;
+}
+
+} // namespace
+
+SolverSelector &SolverSelector::instance() {
+    static SolverSelector selector;
+    return selector;
+}
+
+SolverSelector::SolverSelector() : calibrated(false) {
+    calibrated = loadProfile();
+}
+
+QString SolverSelector::engineName(Engine engine) {
+    switch (engine) {
+    case Constructive:
+        return "Constructive";
+    case Sampler:
+        return "Sampler";
+    case Bitboard:
+        return "Bitboard";
+    case Backtracking:
+        return "Backtracking";
+    case RegionPropagation:
+        return "Region propagation";
+    default:
+        return QString();
+    }
+}
+
+QString SolverSelector::profilePath() {
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)).filePath("solver-profile.json");
+}
+
+SolverSelector::Family SolverSelector::familyOf(const BoardVariant &variant) {
+    return variant.hasRegions() ? Regions : Plain;
+}
+
+bool SolverSelector::isCalibrated() const {
+    QMutexLocker locker(&mutex);
+    return calibrated;
+}
+
+double SolverSelector::predict(Engine engine, int boardSize, Family family) const {
+    const Samples &measured = samples[family][engine];
+    if (measured.empty()) {
+        return defaultMs(engine, boardSize, family == Regions);
+    }
+
+    auto upper = measured.lower_bound(boardSize);
+    if (upper != measured.end() && upper->first == boardSize) {
+        return upper->second;
+    }
+
+    // Costs grow about exponentially with N, so interpolate the logarithm
+    auto logMs = [](double ms) { return std::log(std::max(ms, 1e-5)); };
+    if (upper != measured.begin() && upper != measured.end()) {
+        auto lower = std::prev(upper);
+        double t = double(boardSize - lower->first) / (upper->first - lower->first);
+        return std::exp(logMs(lower->second) + t * (logMs(upper->second) - logMs(lower->second)));
+    }
+    if (upper == measured.end() && measured.size() >= 2) {
+        // Past the largest board measured: keep the growth of the last two points
+        auto last = std::prev(measured.end());
+        auto before = std::prev(last);
+        double slope = std::max(0.0, (logMs(last->second) - logMs(before->second)) / (last->first - before->first));
+        return std::exp(logMs(last->second) + slope * (boardSize - last->first));
+    }
+
+    // Below the smallest board, or a single point: scale linearly
+    auto nearest = upper == measured.end() ? std::prev(measured.end()) : upper;
+    return nearest->second * boardSize / nearest->first;
+}
+
+double SolverSelector::predictedMs(Engine engine, int boardSize, const BoardVariant &variant) const {
+    QMutexLocker locker(&mutex);
+    return predict(engine, boardSize, familyOf(variant));
+}
+
+std::vector<SolverSelector::Engine> SolverSelector::plan(int boardSize, const BoardVariant &variant) const {
+    std::vector<std::pair<double, Engine>> costs;
+    if (boardSize < 1) {
+        return {};
+    }
+
+    QMutexLocker locker(&mutex);
+    for (int engine = 0; engine < EngineCount; ++engine) {
+        if (isApplicable(Engine(engine), boardSize, variant)) {
+            costs.push_back({predict(Engine(engine), boardSize, familyOf(variant)), Engine(engine)});
+        }
+    }
+    std::stable_sort(costs.begin(), costs.end(),
+                     [](const auto &a, const auto &b) { return a.first < b.first; });
+
+    auto sampler = std::find_if(costs.begin(), costs.end(), [](const auto &cost) { return cost.second == Sampler; });
+    if (sampler != costs.end() && sampler->first <= SAMPLER_FIRST_MS) {
+        std::rotate(costs.begin(), sampler, sampler + 1);
+    }
+
+    std::vector<Engine> engines;
+    for (const auto &cost : costs) {
+        engines.push_back(cost.second);
+    }
+    return engines;
+}
+
+std::vector<int> SolverSelector::solve(int boardSize, const BoardVariant &variant, Engine *used, bool *gaveUp) {
+    if (gaveUp) {
+        *gaveUp = false;
+    }
+    if (variant.isUnsolvable(boardSize)) {
+        return {}; // The searches would only prove it the slow way, for hours on a 20x20 torus
+    }
+    const std::vector<Engine> engines = plan(boardSize, variant);
+
+    // Each engine in turn, within a budget of a few times its predicted cost
+    for (Engine engine : engines) {
+        const double budget = BUDGET_FACTOR * predictedMs(engine, boardSize, variant);
+        bool timedOut = false;
+        std::vector<int> cols = runEngine(engine, boardSize, variant,
+                                          QDeadlineTimer(std::max(MIN_BUDGET_MS, qint64(budget))), timedOut);
+        if (!cols.empty()) {
+            if (used) {
+                *used = engine;
+            }
+            return cols;
+        }
+        if (!timedOut && isExhaustive(engine)) {
+            return cols; // Proven: this board has no solution
+        }
+    }
+
+    // Every engine ran out of time: the cheapest complete one gets a longer, still bounded run
+    for (Engine engine : engines) {
+        if (isExhaustive(engine)) {
+            bool timedOut = false;
+            std::vector<int> cols = runEngine(engine, boardSize, variant, QDeadlineTimer(FALLBACK_BUDGET_MS), timedOut);
+            if (used && !cols.empty()) {
+                *used = engine;
+            }
+            if (gaveUp) {
+                *gaveUp = timedOut;
+            }
+            return cols;
+        }
+    }
+    return {};
+}
+
+bool SolverSelector::calibrate(const std::function<void(int, int)> &progress, QString *error) {
+    const int plainSizes = CALIBRATION_MAX_SIZE - CALIBRATION_MIN_SIZE + 1;
+    const int regionSizes = int(std::size(CALIBRATION_REGION_SIZES));
+    const int total = plainSizes * 4 + regionSizes * 3;
+    int done = 0;
+
+    // Measured without the lock, so solves keep using the old model meanwhile
+    Samples measured[FamilyCount][EngineCount];
+    auto measure = [&](Family family, Engine engine, int boardSize, const BoardVariant &variant, bool &slow) {
+        if (!slow && isApplicable(engine, boardSize, variant)) {
+            bool timedOut = false;
+            measured[family][engine][boardSize] = timeEngine(engine, boardSize, variant, timedOut);
+            slow = timedOut; // Larger boards would only time out too
+        }
+        if (progress) {
+            progress(++done, total);
+        }
+    };
+
+    bool slow[EngineCount] = {};
+    for (int boardSize = CALIBRATION_MIN_SIZE; boardSize <= CALIBRATION_MAX_SIZE; ++boardSize) {
+        for (Engine engine : {Constructive, Sampler, Bitboard, Backtracking}) {
+            measure(Plain, engine, boardSize, BoardVariant(), slow[engine]);
+        }
+    }
+
+    std::fill(std::begin(slow), std::end(slow), false);
+    for (int boardSize : CALIBRATION_REGION_SIZES) {
+        BoardVariant variant;
+        variant.regions = RegionPuzzle::generate(boardSize, 500, unsigned(boardSize)).regions;
+        for (Engine engine : {RegionPropagation, Bitboard, Backtracking}) {
+            measure(Regions, engine, boardSize, variant, slow[engine]);
+        }
+    }
+
+    QJsonObject root;
+    root["version"] = PROFILE_VERSION;
+    for (int family = 0; family < FamilyCount; ++family) {
+        QJsonObject engines;
+        for (int engine = 0; engine < EngineCount; ++engine) {
+            QJsonArray points;
+            for (const auto &point : measured[family][engine]) {
+                points.append(QJsonArray{point.first, point.second});
+            }
+            if (!points.isEmpty()) {
+                engines[PROFILE_KEYS[engine]] = points;
+            }
+        }
+        root[FAMILY_KEYS[family]] = engines;
+    }
+
+    {
+        QMutexLocker locker(&mutex);
+        for (int family = 0; family < FamilyCount; ++family) {
+            for (int engine = 0; engine < EngineCount; ++engine) {
+                samples[family][engine] = measured[family][engine];
+            }
+        }
+        calibrated = true;
+    }
+
+    // Used for this session either way, only the next start needs the file
+    QDir().mkpath(QFileInfo(profilePath()).absolutePath());
+    QSaveFile file(profilePath());
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson());
+    if (!file.commit()) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+    return true;
+}
+
+bool SolverSelector::loadProfile() {
+    QFile file(profilePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false; // Never calibrated
+    }
+
+    QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    if (root.value("version").toInt() != PROFILE_VERSION) {
+        return false;
+    }
+
+    for (int family = 0; family < FamilyCount; ++family) {
+        QJsonObject engines = root.value(FAMILY_KEYS[family]).toObject();
+        for (int engine = 0; engine < EngineCount; ++engine) {
+            for (const QJsonValue &point : engines.value(PROFILE_KEYS[engine]).toArray()) {
+                QJsonArray pair = point.toArray();
+                int boardSize = pair.at(0).toInt();
+                double ms = pair.at(1).toDouble(-1);
+                if (boardSize >= 1 && ms >= 0) {
+                    samples[family][engine][boardSize] = ms;
+                }
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,60 @@
+#ifndef SOLVERSELECTOR_H
+#define SOLVERSELECTOR_H
+
+#include <QMutex>
+#include <QString>
+#include <functional>
+#include <map>
+#include <vector>
+#include "boardvariant.h"
+
+// Picks the solver backend for a board from a cost model, cheapest predicted first,
+// and falls back to the next engine when one runs over its time budget.
+// calibrate() measures the engines on this machine and saves them to a small profile
+// file, loaded at startup; without one the built-in estimates are used.
+class SolverSelector {
+
+public:
+    enum Engine {
+        Constructive,      // Closed-form placement, O(N), classic and plain torus boards
+        Sampler,           // Random solution: solution index up to 12, min-conflicts above; classic only
+        Bitboard,          // Bitmask search, up to 64, every variant
+        Backtracking,      // Array backtracking, every variant and size
+        RegionPropagation, // Colored regions only
+        EngineCount
+    };
+
+    static SolverSelector &instance();
+    static QString engineName(Engine engine);
+
+    // Engines able to solve this board, cheapest predicted first, except that a quick
+    // Sampler goes first so solutions stay random
+    std::vector<Engine> plan(int boardSize, const BoardVariant &variant) const;
+    double predictedMs(Engine engine, int boardSize, const BoardVariant &variant) const;
+
+    // Column of the queen on each row, or empty if there is none. *used is the engine that answered;
+    // *gaveUp is set when even the last exhaustive run hit its cap, so "none" isn't proven.
+    std::vector<int> solve(int boardSize, const BoardVariant &variant, Engine *used = nullptr, bool *gaveUp = nullptr);
+
+    // Times every engine on this machine, then saves the profile. progress(done, total) may be empty.
+    bool calibrate(const std::function<void(int, int)> &progress = {}, QString *error = nullptr);
+    bool isCalibrated() const;
+    static QString profilePath();
+
+private:
+    SolverSelector();
+
+    // Plain: classic boards and the other rule variants; regions have their own costs
+    enum Family { Plain, Regions, FamilyCount };
+    using Samples = std::map<int, double>; // Board size -> ms
+    static Family familyOf(const BoardVariant &variant);
+
+    mutable QMutex mutex;
+    Samples samples[FamilyCount][EngineCount];
+    bool calibrated;
+
+    double predict(Engine engine, int boardSize, Family family) const; // Caller holds the mutex
+    bool loadProfile();
+};
+
+#endif // SOLVERSELECTOR_H
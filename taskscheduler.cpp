@@ -0,0 +1,95 @@
+#include "taskscheduler.h"
+
+#include <QMutex>
+#include <QSettings>
+#include <QThread>
+#include <QWaitCondition>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace {
+
+// Shared with the helper tasks, which may only get a thread after the work is already done
+struct ForState {
+    std::function<void(int)> function;
+    int count;
+    std::atomic<int> next{0};
+    QMutex mutex;
+    QWaitCondition allDone;
+    int done = 0;
+    QThreadPool *pool;
+    int priority;
+};
+
+bool runNext(ForState &state) {
+    const int index = state.next++;
+    if (index >= state.count) {
+        return false;
+    }
+    state.function(index);
+
+    QMutexLocker locker(&state.mutex);
+    if (++state.done == state.count) {
+        state.allDone.wakeAll();
+    }
+    return true;
+}
+
+// One index per task, then back into the queue: between two units the thread
+// goes to whatever has the highest priority, which is how interactive work preempts
+void runHelper(const std::shared_ptr<ForState> &state) {
+    if (runNext(*state) && state->next < state->count) {
+        state->pool->start([state]() { runHelper(state); }, state->priority);
+    }
+}
+
+} // namespace
+
+TaskScheduler &TaskScheduler::instance() {
+    static TaskScheduler scheduler;
+    return scheduler;
+}
+
+TaskScheduler::TaskScheduler() {
+    int threads = qEnvironmentVariableIntValue("QTQUEENS_THREADS");
+    if (threads <= 0) {
+        threads = QSettings("QtQueens", "QtQueens").value("coreBudget", QThread::idealThreadCount()).toInt();
+    }
+    threadPool.setMaxThreadCount(std::max(1, threads));
+}
+
+int TaskScheduler::coreBudget() const {
+    return threadPool.maxThreadCount();
+}
+
+void TaskScheduler::setCoreBudget(int threads) {
+    threads = std::max(1, threads);
+    threadPool.setMaxThreadCount(threads);
+    QSettings("QtQueens", "QtQueens").setValue("coreBudget", threads);
+}
+
+void TaskScheduler::blockingFor(int count, Priority priority, const std::function<void(int)> &function) {
+    if (count <= 0) {
+        return;
+    }
+
+    auto state = std::make_shared<ForState>();
+    state->function = function;
+    state->count = count;
+    state->pool = &threadPool;
+    state->priority = priority;
+
+    const int helpers = std::min(count, coreBudget()) - 1;
+    for (int i = 0; i < helpers; ++i) {
+        threadPool.start([state]() { runHelper(state); }, priority);
+    }
+    while (runNext(*state)) {
+        // The caller keeps going until every index is taken
+    }
+
+    QMutexLocker locker(&state->mutex);
+    while (state->done < state->count) {
+        state->allDone.wait(&state->mutex);
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef TASKSCHEDULER_H
+#define TASKSCHEDULER_H
+
+#include <QList>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <QEventLoop>
+#include <QFutureWatcher>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+// The one thread pool shared by hints, solving, puzzle generation, counting and the service.
+// Queued work starts by priority, so interactive requests get the next free thread as soon
+// as a long counting job finishes its current work unit. At most coreBudget() threads run;
+// the budget comes from QTQUEENS_THREADS, then the saved setting, then the core count.
+class TaskScheduler {
+
+public:
+    enum Priority {
+        Background = 0,  // Counting and enumeration
+        Normal = 1,
+        Interactive = 2  // Hints, solving, new games: someone is waiting for it
+    };
+
+    static TaskScheduler &instance();
+
+    int coreBudget() const;
+    void setCoreBudget(int threads); // Also saved for the next run
+
+    // Runs function() on the pool, result in the returned future
+    template <typename Function>
+    auto run(Priority priority, Function &&function) {
+        return QtConcurrent::task(std::forward<Function>(function))
+            .onThreadPool(threadPool).withPriority(priority).spawn();
+    }
+
+    // Runs function() at interactive priority and returns its result, for the GUI thread:
+    // windows keep repainting meanwhile, user input waits until it is done.
+    template <typename Function>
+    std::invoke_result_t<Function> runInteractive(Function function) {
+        QFutureWatcher<std::invoke_result_t<Function>> watcher;
+        QEventLoop loop;
+        QObject::connect(&watcher, &QFutureWatcherBase::finished, &loop, &QEventLoop::quit);
+        watcher.setFuture(run(Interactive, std::move(function)));
+        if (!watcher.isFinished()) {
+            loop.exec(QEventLoop::ExcludeUserInputEvents);
+        }
+        return watcher.result();
+    }
+
+    // Calls function(index) for every index in [0, count) and returns once all are done.
+    // The calling thread takes indices too, so a pool thread may call this without deadlocking.
+    void blockingFor(int count, Priority priority, const std::function<void(int)> &function);
+
+    template <typename Result, typename Sequence, typename Function>
+    QList<Result> blockingMapped(const Sequence &items, Priority priority, Function function) {
+        QList<Result> results(items.size());
+        blockingFor(int(items.size()), priority, [&](int index) {
+            results[index] = function(items[index]);
+        });
+        return results;
+    }
+
+private:
+    TaskScheduler();
+
+    QThreadPool threadPool;
+};
+
+#endif // TASKSCHEDULER_H
@@ -9,3 +9,15 @@ QPixmap tintPixmap(const QPixmap &original, const QColor &color) {
     painter.end();
     return tinted;
 }
+
+QPixmap queenPixmap(bool conflicted) {
+    static int cachedSize = -1;
+    static QPixmap normal;
+    static QPixmap red;
+    if (cachedSize != SQUARE_SIZE) {
+        normal = QPixmap(":/resources/queen.png").scaled(SQUARE_SIZE, SQUARE_SIZE);
+        red = tintPixmap(normal, Qt::red);
+        cachedSize = SQUARE_SIZE;
+    }
+    return conflicted ? red : normal;
+}
@@ -9,4 +9,8 @@ extern int SQUARE_SIZE;
 // Function to tint a QPixmap with a specific color
 QPixmap tintPixmap(const QPixmap &original, const QColor &color);
 
+// The queen image at the current SQUARE_SIZE, tinted red for a queen in conflict.
+// Loaded and scaled once per square size, every queen shares the same pixmap.
+QPixmap queenPixmap(bool conflicted = false);
+
 #endif // UTILS_H
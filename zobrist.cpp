@@ -0,0 +1,54 @@
+#include "zobrist.h"
+
+#include <array>
+#include <random>
+
+namespace {
+
+constexpr int TABLE_SIZE = 64;
+
+std::array<quint64, TABLE_SIZE * TABLE_SIZE> makeTable() {
+    std::array<quint64, TABLE_SIZE * TABLE_SIZE> table;
+    std::mt19937_64 rng(0x51ee75); // Fixed seed, hashes are stable across runs
+    for (quint64 &entry : table) {
+        entry = rng();
+    }
+    return table;
+}
+
+// splitmix64, for squares outside the table
+quint64 mix(quint64 value) {
+    value += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
+} // namespace
+
+ZobristHash::ZobristHash() : hash(0) {
+}
+
+quint64 ZobristHash::key(int row, int col) {
+    static const std::array<quint64, TABLE_SIZE * TABLE_SIZE> table = makeTable();
+    if (row >= 0 && row < TABLE_SIZE && col >= 0 && col < TABLE_SIZE) {
+        return table[row * TABLE_SIZE + col];
+    }
+    return mix((quint64(quint32(row)) << 32) | quint32(col));
+}
+
+void ZobristHash::toggle(int row, int col) {
+    hash ^= key(row, col);
+}
+
+void ZobristHash::move(int fromRow, int fromCol, int toRow, int toCol) {
+    hash ^= key(fromRow, fromCol) ^ key(toRow, toCol);
+}
+
+void ZobristHash::reset() {
+    hash = 0;
+}
+
+quint64 ZobristHash::value() const {
+    return hash;
+}
@@ -0,0 +1,25 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <QtGlobal>
+
+// Zobrist hash of a set of queens: the XOR of one random key per occupied square.
+// Adding, removing or moving a queen is a couple of XORs, and the same set of
+// squares always hashes the same however it was reached.
+class ZobristHash {
+
+public:
+    ZobristHash();
+
+    void toggle(int row, int col); // Add or remove a queen
+    void move(int fromRow, int fromCol, int toRow, int toCol);
+    void reset();
+    quint64 value() const;
+
+    static quint64 key(int row, int col);
+
+private:
+    quint64 hash;
+};
+
+#endif // ZOBRIST_H